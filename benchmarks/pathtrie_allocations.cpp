@@ -0,0 +1,92 @@
+// -*- coding: utf-8 -*-
+
+// Copyright 2025 (c) Vladislav Punko <iam.vlad.punko@gmail.com>
+
+// Measures steady-state insertion into an already populated trie and verifies
+// that re-inserting known prefixes never reaches the allocator.
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "pathtrie.h"
+
+namespace {
+
+std::atomic<size_t> allocations{0};
+
+std::vector<std::string>
+MakeCorpus(size_t count)
+{
+    std::vector<std::string> paths;
+    paths.reserve(count);
+
+    for (size_t i = 0; i < count; ++i) {
+        paths.push_back("/data/set-" + std::to_string(i % 64) + "/part-" +
+                        std::to_string(i % 4096) + "/chunk-" + std::to_string(i));
+    }
+
+    return paths;
+}
+
+} // namespace
+
+void *
+operator new(size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+
+    if (void *ptr = std::malloc(size ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void
+operator delete(void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void
+operator delete(void *ptr, size_t) noexcept
+{
+    std::free(ptr);
+}
+
+int
+main()
+{
+    constexpr size_t kPaths = 1 << 20;
+    constexpr size_t kRounds = 5;
+
+    const std::vector<std::string> paths = MakeCorpus(kPaths);
+
+    pyftpkit::PathTrie trie;
+    for (const auto &path : paths) {
+        trie.Insert(path);
+    }
+
+    size_t before = allocations.load();
+    auto start = std::chrono::steady_clock::now();
+
+    for (size_t round = 0; round < kRounds; ++round) {
+        for (const auto &path : paths) {
+            trie.Insert(path);
+        }
+    }
+
+    auto elapsed = std::chrono::duration<double, std::nano>(
+        std::chrono::steady_clock::now() - start);
+    size_t steady = allocations.load() - before;
+
+    std::printf("steady-state inserts: %zu\n", kPaths * kRounds);
+    std::printf("time per insert:      %.1f ns\n", elapsed.count() / (kPaths * kRounds));
+    std::printf("allocations:          %zu\n", steady);
+
+    return steady == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,198 @@
+// -*- coding: utf-8 -*-
+
+// Copyright 2025 (c) Vladislav Punko <iam.vlad.punko@gmail.com>
+
+// Times the core trie operations on reproducible path corpora and reports the
+// peak resident set size after every phase. The peak never goes down within a
+// process, so memory figures are only meaningful with one corpus per run.
+//
+// Usage: pathtrie_benchmark [deep|wide|mixed|all] [number of paths]
+
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "pathtrie.h"
+#include "pathtrie_iterator.h"
+
+namespace {
+
+// Binary tree of depth 32: every path is the bit pattern of its index, so
+// directories have two children at most but the paths are long.
+std::vector<std::string>
+MakeDeepCorpus(size_t count)
+{
+    std::vector<std::string> paths;
+    paths.reserve(count);
+
+    for (size_t i = 0; i < count; ++i) {
+        std::string path = "/deep";
+        for (size_t bit = 0; bit < 32; ++bit) {
+            path += (i >> bit) & 1 ? "/b1" : "/b0";
+        }
+        paths.push_back(std::move(path));
+    }
+
+    return paths;
+}
+
+// A handful of directories with a huge number of files each.
+std::vector<std::string>
+MakeWideCorpus(size_t count)
+{
+    std::vector<std::string> paths;
+    paths.reserve(count);
+
+    for (size_t i = 0; i < count; ++i) {
+        paths.push_back("/wide/dir-" + std::to_string(i % 16) + "/file-" +
+                        std::to_string(i) + ".dat");
+    }
+
+    return paths;
+}
+
+// Mirrors typical storage layouts: the depth follows a geometric distribution
+// and directory names are drawn from a skewed vocabulary, so a few popular
+// prefixes are shared by most of the paths.
+std::vector<std::string>
+MakeMixedCorpus(size_t count)
+{
+    std::vector<std::string> paths;
+    paths.reserve(count);
+
+    std::mt19937_64 engine(42);  // fixed seed for comparable runs
+    std::geometric_distribution<size_t> depth(0.3);
+    std::uniform_real_distribution<double> rank(0.0, std::log(1000.0));
+
+    for (size_t i = 0; i < count; ++i) {
+        std::string path = "/data";
+        for (size_t level = 0, levels = 1 + std::min<size_t>(depth(engine), 12);
+             level < levels; ++level) {
+            path += "/dir-" + std::to_string(static_cast<size_t>(std::exp(rank(engine))));
+        }
+        path += "/file-" + std::to_string(i) + ".dat";
+        paths.push_back(std::move(path));
+    }
+
+    return paths;
+}
+
+template <typename Function>
+double
+Measure(Function &&function)
+{
+    auto start = std::chrono::steady_clock::now();
+    function();
+
+    return std::chrono::duration<double, std::nano>(
+               std::chrono::steady_clock::now() - start)
+        .count();
+}
+
+double
+PeakMemory()
+{
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+
+#ifdef __APPLE__
+    return static_cast<double>(usage.ru_maxrss) / (1 << 20);  // bytes
+#else
+    return static_cast<double>(usage.ru_maxrss) / (1 << 10);  // kilobytes
+#endif
+}
+
+void
+Report(const char *phase, double nanoseconds, size_t count)
+{
+    std::printf("  %-22s %12.1f ms %10.1f ns/path %10.1f MB peak RSS\n",
+                phase,
+                nanoseconds / 1e6,
+                nanoseconds / static_cast<double>(count ? count : 1),
+                PeakMemory());
+}
+
+void
+Run(const char *name, const std::vector<std::string> &paths)
+{
+    std::printf("%s: %zu paths\n", name, paths.size());
+
+    pyftpkit::PathTrie trie;
+    Report("Insert", Measure([&] {
+               for (const auto &path : paths) {
+                   trie.Insert(path);
+               }
+           }),
+           paths.size());
+
+    // Re-inserting known paths only follows existing nodes.
+    Report("Insert (existing)", Measure([&] {
+               for (const auto &path : paths) {
+                   trie.Insert(path);
+               }
+           }),
+           paths.size());
+
+    size_t unique = 0;
+    double elapsed = Measure([&] { unique = trie.GetAllUniquePaths().size(); });
+    Report("GetAllUniquePaths", elapsed, unique);
+
+    // The native part of PathTrieIterator::Next() without building Python
+    // strings, which the binding benchmarks cover.
+    size_t visited = 0;
+    size_t bytes = 0;
+    elapsed = Measure([&] {
+        pyftpkit::PathTrieIterator iterator(trie);
+        while (iterator.Advance()) {
+            bytes += iterator.Path().size();
+            ++visited;
+        }
+    });
+    Report("PathTrieIterator::Next", elapsed, visited);
+
+    Report("Clear", Measure([&] { trie.Clear(); }), paths.size());
+
+    // Keeps the traversal from being optimized away.
+    std::printf("  %zu unique paths, %zu visited, %zu bytes\n", unique, visited, bytes);
+}
+
+} // namespace
+
+int
+main(int argc, char **argv)
+{
+    const char *corpus = argc > 1 ? argv[1] : "all";
+    const size_t count = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1 << 20;
+
+    const bool all = std::strcmp(corpus, "all") == 0;
+    bool known = all;
+
+    if (all || std::strcmp(corpus, "deep") == 0) {
+        Run("deep", MakeDeepCorpus(count));
+        known = true;
+    }
+    if (all || std::strcmp(corpus, "wide") == 0) {
+        Run("wide", MakeWideCorpus(count));
+        known = true;
+    }
+    if (all || std::strcmp(corpus, "mixed") == 0) {
+        Run("mixed", MakeMixedCorpus(count));
+        known = true;
+    }
+
+    if (!known) {
+        std::fprintf(stderr, "unknown corpus: %s\n", corpus);
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,67 @@
+# -*- coding: utf-8 -*-
+
+# Copyright 2025 (c) Vladislav Punko <iam.vlad.punko@gmail.com>
+
+# Measures what the Python binding adds on top of the native trie operations
+# timed by pathtrie_benchmark. Run with: pytest benchmarks
+
+import collections
+
+import pytest
+
+from pyftpkit._pathtrie import PathTrie
+
+pytest.importorskip("pytest_benchmark")
+
+NUMBER_OF_PATHS = 100_000
+
+
+@pytest.fixture(scope="module")
+def paths():
+    return [
+        f"/data/dir-{i % 100}/sub-{i % 7}/file-{i}.dat" for i in range(NUMBER_OF_PATHS)
+    ]
+
+
+@pytest.fixture(scope="module")
+def trie(paths):
+    trie = PathTrie()
+    trie.insert_many(paths)
+
+    return trie
+
+
+def test_insert(benchmark, paths):
+    def insert():
+        trie = PathTrie()
+        for path in paths:
+            trie.insert(path)
+
+    benchmark(insert)
+
+
+@pytest.mark.parametrize("threads", [1, 4])
+def test_insert_many(benchmark, paths, threads):
+    benchmark(lambda: PathTrie().insert_many(paths, threads=threads))
+
+
+def test_insert_many_buffer(benchmark, paths):
+    buffer = "\n".join(paths).encode()
+    benchmark(lambda: PathTrie().insert_many(buffer))
+
+
+def test_iterate(benchmark, trie):
+    benchmark(lambda: collections.deque(trie, maxlen=0))
+
+
+@pytest.mark.parametrize("batch_size", [1_000, 10_000])
+def test_iterate_batches(benchmark, trie, batch_size):
+    benchmark(lambda: collections.deque(trie.__iter__(batch_size), maxlen=0))
+
+
+def test_levels(benchmark, trie):
+    benchmark(lambda: collections.deque(trie.levels(), maxlen=0))
+
+
+def test_get_all_unique_paths(benchmark, trie):
+    benchmark(trie.get_all_unique_paths)
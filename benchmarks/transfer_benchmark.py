@@ -0,0 +1,437 @@
+# -*- coding: utf-8 -*-
+
+# Copyright 2025 (c) Vladislav Punko <iam.vlad.punko@gmail.com>
+
+"""End-to-end throughput benchmarks against a local FTP server.
+
+Generates a local directory tree, serves an empty home directory with pyftpdlib
+and runs every selected operation for each combination of the swept pool sizes:
+``FTPLoader.upload``, ``FTPFileSystem.walk``, ``FTPLoader.download``,
+``FTPFileSystem.makedirs`` and ``FTPFileSystem.rmtree``.
+
+Latencies are measured by the server from the receipt of a command to its final
+reply, so transfers include the data connection and every injected delay. The
+injected latency is added once per command and once per accepted connection,
+which models the round trips of a remote server but not its bandwidth.
+
+Usage: python benchmarks/transfer_benchmark.py --shape wide --sizes fixed:65536
+           --max-connections 1 4 16 --max-workers 32 --latency 20
+"""
+
+import argparse
+import asyncio
+import collections
+import contextlib
+import json
+import logging
+import math
+import os
+import pathlib
+import random
+import secrets
+import shutil
+import statistics
+import tempfile
+import threading
+import time
+import typing
+
+from pyftpdlib.authorizers import DummyAuthorizer
+from pyftpdlib.handlers import FTPHandler
+from pyftpdlib.servers import ThreadedFTPServer
+
+from pyftpkit.connection_parameters import ConnectionParameters
+from pyftpkit.ftpfs import FTPFileSystem
+from pyftpkit.loader import FTPLoader
+
+USERNAME: typing.Final[str] = "benchmark"
+PASSWORD: typing.Final[str] = secrets.token_urlsafe(32)
+
+OPERATIONS: typing.Final[tuple[str, ...]] = (
+    "upload",
+    "walk",
+    "download",
+    "makedirs",
+    "rmtree",
+)
+
+# Commands whose latencies are reported for each operation.
+COMMANDS: typing.Final[dict[str, frozenset[str]]] = {
+    "upload": frozenset({"STOR"}),
+    "walk": frozenset({"LIST", "MLSD"}),
+    "download": frozenset({"RETR"}),
+    "makedirs": frozenset({"MKD"}),
+    "rmtree": frozenset({"DELE", "RMD"}),
+}
+
+# Depth of the tree, subdirectories per directory and files per directory.
+SHAPES: typing.Final[dict[str, tuple[int, int, int]]] = {
+    "deep": (16, 1, 8),
+    "wide": (1, 16, 128),
+    "balanced": (3, 4, 16),
+}
+
+# Random content shared by all generated files.
+_BLOCK: typing.Final[bytes] = os.urandom(1 << 20)
+
+
+class Tree(typing.NamedTuple):
+    root: pathlib.Path
+    dirs: list[pathlib.PurePosixPath]
+    files: int
+    size: int
+
+
+class Result(typing.NamedTuple):
+    operation: str
+    max_connections: int
+    max_workers: int
+    items: int
+    seconds: float
+    size: int
+    p50: float
+    p99: float
+    connections: int
+    peak_connections: int
+
+    def __str__(self) -> str:
+        return (
+            f"{self.operation:<9} {self.max_connections:>5} {self.max_workers:>7}"
+            f" {self.items:>8} {self.seconds:>9.3f} {self.items / self.seconds:>10.1f}"
+            f" {self.size / self.seconds / (1 << 20):>8.1f}"
+            f" {self.p50 * 1e3:>8.2f} {self.p99 * 1e3:>8.2f}"
+            f" {self.connections:>6} {self.peak_connections:>5}"
+        )
+
+
+HEADER: typing.Final[str] = (
+    "operation conns workers    items   seconds    items/s     MB/s"
+    "   p50 ms   p99 ms opened  peak"
+)
+
+
+class ServerStatistics:
+    """Collects connection counts and command latencies across server threads."""
+
+    def __init__(self) -> None:
+        self._lock = threading.Lock()
+
+        self.connections: int = 0
+        self.active: int = 0
+        self.peak: int = 0
+        self.latencies: collections.defaultdict[str, list[float]]
+
+        self.reset()
+
+    def reset(self) -> None:
+        with self._lock:
+            self.connections = 0
+            self.peak = self.active
+            self.latencies = collections.defaultdict(list)
+
+    def connect(self) -> None:
+        with self._lock:
+            self.connections += 1
+            self.active += 1
+            self.peak = max(self.peak, self.active)
+
+    def disconnect(self) -> None:
+        with self._lock:
+            self.active -= 1
+
+    def record(self, command: str, seconds: float) -> None:
+        with self._lock:
+            self.latencies[command].append(seconds)
+
+    def percentiles(self, commands: typing.Iterable[str]) -> tuple[float, float]:
+        with self._lock:
+            samples = [
+                value for command in commands for value in self.latencies[command]
+            ]
+
+        if len(samples) < 2:
+            return (samples[0], samples[0]) if samples else (0.0, 0.0)
+
+        quantiles = statistics.quantiles(samples, n=100, method="inclusive")
+
+        return quantiles[49], quantiles[98]
+
+
+def make_handler(stats: ServerStatistics, latency: float) -> type[FTPHandler]:
+    """Creates an FTP handler reporting to the statistics with delayed replies."""
+
+    class Handler(FTPHandler):
+        _command: str | None = None
+        _started: float = 0.0
+
+        def on_connect(self) -> None:
+            stats.connect()
+
+            if latency:
+                time.sleep(latency)
+
+        def on_disconnect(self) -> None:
+            stats.disconnect()
+
+        def process_command(self, cmd: str, *args: typing.Any, **kwargs: typing.Any):
+            # Every connection is served by its own thread, so sleeping here only
+            # delays the client that sent this command.
+            if latency:
+                time.sleep(latency)
+
+            self._command, self._started = cmd, time.perf_counter()
+
+            return super().process_command(cmd, *args, **kwargs)
+
+        def respond(self, resp: str, *args: typing.Any, **kwargs: typing.Any):
+            result = super().respond(resp, *args, **kwargs)
+
+            # Preliminary replies only announce the start of a data transfer.
+            if self._command is not None and not resp.startswith("1"):
+                stats.record(self._command, time.perf_counter() - self._started)
+                self._command = None
+
+            return result
+
+    return Handler
+
+
+@contextlib.contextmanager
+def serve(
+    home: pathlib.Path, stats: ServerStatistics, latency: float
+) -> typing.Iterator[tuple[str, int]]:
+    """Runs an FTP server for the home directory in a background thread."""
+    authorizer = DummyAuthorizer()
+    authorizer.add_user(USERNAME, PASSWORD, str(home), perm="elradfmw")
+
+    handler = make_handler(stats, latency)
+    handler.authorizer = authorizer
+
+    server = ThreadedFTPServer(("127.0.0.1", 0), handler)
+
+    thread = threading.Thread(target=server.serve_forever, daemon=True)
+    thread.start()
+
+    try:
+        yield server.address
+    finally:
+        server.close_all()
+        thread.join()
+
+
+def parse_sizes(spec: str) -> typing.Callable[[random.Random], int]:
+    """Parses fixed:N, uniform:LOW:HIGH or lognormal:MEDIAN:SIGMA in bytes."""
+    kind, *values = spec.split(":")
+
+    match kind, [float(value) for value in values]:
+        case "fixed", [size]:
+            return lambda rng: int(size)
+
+        case "uniform", [low, high]:
+            return lambda rng: rng.randint(int(low), int(high))
+
+        case "lognormal", [median, sigma]:
+            return lambda rng: int(rng.lognormvariate(math.log(median), sigma))
+
+    raise argparse.ArgumentTypeError(f"Invalid size distribution: {spec!s}")
+
+
+def generate_tree(
+    root: pathlib.Path,
+    shape: tuple[int, int, int],
+    sizes: typing.Callable[[random.Random], int],
+    seed: int,
+) -> Tree:
+    """Writes a reproducible directory tree with files on every level."""
+    depth, fanout, files_per_dir = shape
+    rng = random.Random(seed)
+
+    dirs: list[pathlib.PurePosixPath] = []
+    files = size = 0
+
+    pending = [(pathlib.PurePosixPath(), 0)]
+    while pending:
+        relpath, level = pending.pop()
+        dirs.append(relpath)
+
+        path = root / relpath
+        path.mkdir(parents=True, exist_ok=True)
+
+        for index in range(files_per_dir):
+            file_size = sizes(rng)
+            with open(path / f"file-{index:05d}.bin", "wb") as stream:
+                for offset in range(0, file_size, len(_BLOCK)):
+                    stream.write(_BLOCK[: min(len(_BLOCK), file_size - offset)])
+
+            files += 1
+            size += file_size
+
+        if level < depth:
+            for index in range(fanout):
+                pending.append((relpath / f"dir-{index:03d}", level + 1))
+
+    return Tree(root=root, dirs=dirs, files=files, size=size)
+
+
+async def run_operation(
+    operation: str,
+    tree: Tree,
+    workdir: pathlib.Path,
+    connection_parameters: ConnectionParameters,
+    pipeline: bool,
+) -> tuple[int, int]:
+    """Runs one operation and returns the number of items and bytes it moved."""
+    match operation:
+        case "upload":
+            async with FTPLoader(connection_parameters) as loader:
+                await loader.upload(tree.root, "/tree", pipeline=pipeline)
+
+            return tree.files, tree.size
+
+        case "walk":
+            count = 0
+            async with FTPFileSystem(connection_parameters) as ftpfs:
+                async for _ in ftpfs.walk("/tree"):
+                    count += 1
+
+            return count, 0
+
+        case "download":
+            async with FTPLoader(connection_parameters) as loader:
+                await loader.download("/tree", workdir / "download", pipeline=pipeline)
+
+            return tree.files, tree.size
+
+        case "makedirs":
+            paths = [f"/made/{path!s}" for path in tree.dirs]
+            async with FTPFileSystem(connection_parameters) as ftpfs:
+                await ftpfs.makedirs(paths)
+
+            return len(paths), 0
+
+        case "rmtree":
+            async with FTPFileSystem(connection_parameters) as ftpfs:
+                await ftpfs.rmtree("/tree")
+
+            return len(tree.dirs) + tree.files, 0
+
+    raise ValueError(f"Unknown operation: {operation!s}")
+
+
+async def run(arguments: argparse.Namespace) -> list[Result]:
+    operations = [name for name in OPERATIONS if name in arguments.operations]
+    stats = ServerStatistics()
+    results: list[Result] = []
+
+    with tempfile.TemporaryDirectory(prefix="pyftpkit-benchmark-") as tempdir:
+        workdir = pathlib.Path(tempdir)
+
+        shape = SHAPES[arguments.shape]
+        shape = (
+            shape[0] if arguments.depth is None else arguments.depth,
+            shape[1] if arguments.fanout is None else arguments.fanout,
+            shape[2] if arguments.files is None else arguments.files,
+        )
+        tree = generate_tree(workdir / "source", shape, arguments.sizes, arguments.seed)
+
+        for max_connections in arguments.max_connections:
+            for max_workers in arguments.max_workers:
+                home = workdir / "home"
+                home.mkdir()
+
+                # Later operations need the remote tree even without an upload.
+                if "upload" not in operations:
+                    shutil.copytree(tree.root, home / "tree")
+
+                with serve(home, stats, arguments.latency / 1e3) as (host, port):
+                    connection_parameters = ConnectionParameters.model_validate(
+                        {
+                            "host": host,
+                            "port": port,
+                            "credentials": {"username": USERNAME, "password": PASSWORD},
+                            "max_connections": max_connections,
+                            "max_workers": max_workers,
+                            "backend": arguments.backend,
+                        }
+                    )
+
+                    for operation in operations:
+                        stats.reset()
+
+                        started = time.perf_counter()
+                        items, size = await run_operation(
+                            operation,
+                            tree,
+                            workdir,
+                            connection_parameters,
+                            arguments.pipeline,
+                        )
+                        seconds = time.perf_counter() - started
+
+                        p50, p99 = stats.percentiles(COMMANDS[operation])
+                        result = Result(
+                            operation=operation,
+                            max_connections=max_connections,
+                            max_workers=max_workers,
+                            items=items,
+                            seconds=seconds,
+                            size=size,
+                            p50=p50,
+                            p99=p99,
+                            connections=stats.connections,
+                            peak_connections=stats.peak,
+                        )
+                        results.append(result)
+
+                        if arguments.json:
+                            print(json.dumps(result._asdict()), flush=True)
+                        else:
+                            print(result, flush=True)
+
+                shutil.rmtree(home)
+                shutil.rmtree(workdir / "download", ignore_errors=True)
+
+    return results
+
+
+def main() -> None:
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--shape", choices=SHAPES, default="balanced")
+    parser.add_argument("--depth", type=int, help="override the depth of the shape")
+    parser.add_argument("--fanout", type=int, help="subdirectories per directory")
+    parser.add_argument("--files", type=int, help="files per directory")
+    parser.add_argument(
+        "--sizes",
+        type=parse_sizes,
+        default=parse_sizes("lognormal:16384:1.5"),
+        help="file size distribution in bytes (default: lognormal:16384:1.5)",
+    )
+    parser.add_argument("--seed", type=int, default=0)
+    parser.add_argument(
+        "--operations", nargs="+", choices=OPERATIONS, default=list(OPERATIONS)
+    )
+    parser.add_argument("--max-connections", type=int, nargs="+", default=[1, 4, 16])
+    parser.add_argument("--max-workers", type=int, nargs="+", default=[32])
+    parser.add_argument("--backend", choices=("threads", "asyncio"), default="threads")
+    parser.add_argument("--pipeline", action="store_true")
+    parser.add_argument(
+        "--latency",
+        type=float,
+        default=0.0,
+        help="delay in milliseconds added to every command and connection",
+    )
+    parser.add_argument("--json", action="store_true", help="print JSON lines")
+    arguments = parser.parse_args()
+
+    # Progress messages would only distort the measurements.
+    logging.getLogger("pyftpkit").setLevel(logging.WARNING)
+    logging.getLogger("pyftpdlib").setLevel(logging.WARNING)
+
+    if not arguments.json:
+        print(HEADER, flush=True)
+
+    asyncio.run(run(arguments))
+
+
+if __name__ == "__main__":
+    main()
@@ -32,6 +32,7 @@ logger = logging.getLogger("pyftpkit")
 
 class FTPCommand(enum.Enum):
     DOWNLOAD = "download"
+    SYNC = "sync"
     UPLOAD = "upload"
 
 
@@ -49,6 +50,15 @@ class SingleOrList(argparse.Action):
         setattr(namespace, self.dest, first if not other else values)
 
 
+def _endpoint(value: str) -> dict[str, str | int]:
+    """Parses a mirror given as HOST[:PORT[:MAX_CONNECTIONS]]."""
+    host, *numbers = value.split(":")
+    if not host or len(numbers) > 2 or not all(n.isdigit() for n in numbers):
+        raise argparse.ArgumentTypeError(f"Invalid mirror: {value!s}")
+
+    return dict(zip(("host", "port", "max_connections"), [host, *map(int, numbers)]))
+
+
 async def _main() -> None:
     """The command-line interface."""
     parser = argparse.ArgumentParser(
@@ -97,6 +107,26 @@ async def _main() -> None:
         metavar="N",
         help="maximum number of simultaneous FTP connections",
     )
+    parser.add_argument(
+        "--min-connections",
+        type=int,
+        metavar="N",
+        help="number of FTP connections opened upfront",
+    )
+    parser.add_argument(
+        "--keepalive-interval",
+        type=int,
+        metavar="SECONDS",
+        help="check pooled FTP connections idle for this long with NOOP",
+    )
+    parser.add_argument(
+        "--mirror",
+        type=_endpoint,
+        action="append",
+        dest="mirrors",
+        metavar="HOST[:PORT[:N]]",
+        help="another server with the same files, can be given many times",
+    )
     parser.add_argument(
         "--max-workers",
         type=int,
@@ -106,6 +136,30 @@ async def _main() -> None:
             "\n(threads per connection)"
         ),
     )
+    parser.add_argument(
+        "--buffer-size",
+        type=int,
+        metavar="BYTES",
+        help="size of the receive buffer for downloads",
+    )
+    parser.add_argument(
+        "--preallocate",
+        action="store_true",
+        default=None,
+        help="reserve disk space for downloads before writing them",
+    )
+    parser.add_argument(
+        "--segment-threshold",
+        type=int,
+        metavar="BYTES",
+        help="download larger files in parallel segments",
+    )
+    parser.add_argument(
+        "--retries",
+        type=int,
+        metavar="N",
+        help="times a failed transfer is repeated before giving up on it",
+    )
 
     subparsers = parser.add_subparsers(dest="cmd", required=True)
 
@@ -133,6 +187,39 @@ async def _main() -> None:
         help="local destination path(s) where the files or directories will be saved",
     )
 
+    sync_parser = subparsers.add_parser(
+        FTPCommand.SYNC.value, help="Download only files changed since the last sync."
+    )
+    sync_parser.add_argument(
+        "-s",
+        "--src",
+        type=pathlib.Path,
+        required=True,
+        metavar="SRC",
+        help="remote directory on the FTP server to synchronize",
+    )
+    sync_parser.add_argument(
+        "-d",
+        "--dst",
+        type=pathlib.Path,
+        required=True,
+        metavar="DST",
+        help="local directory where the files will be saved",
+    )
+    sync_parser.add_argument(
+        "-i",
+        "--index",
+        type=pathlib.Path,
+        required=True,
+        metavar="PATH",
+        help="index of the remote tree kept between runs",
+    )
+    sync_parser.add_argument(
+        "--prune",
+        action="store_true",
+        help="skip subdirectories whose modification time did not change",
+    )
+
     upload_parser = subparsers.add_parser(
         FTPCommand.UPLOAD.value, help="Upload local files or directories."
     )
@@ -161,15 +248,24 @@ async def _main() -> None:
     try:
         arguments = parser.parse_args()
 
-        ftp_loader = FTPLoader(
+        # One pool of sessions serves every step of the command.
+        async with FTPLoader(
             connections_parameters=ConnectionParameters.from_arguments(arguments)
-        )
-        match FTPCommand(arguments.cmd):
-            case FTPCommand.DOWNLOAD:
-                await ftp_loader.download(arguments.src, arguments.dst)
+        ) as ftp_loader:
+            match FTPCommand(arguments.cmd):
+                case FTPCommand.DOWNLOAD:
+                    await ftp_loader.download(arguments.src, arguments.dst)
+
+                case FTPCommand.SYNC:
+                    await ftp_loader.sync(
+                        arguments.src,
+                        arguments.dst,
+                        index=arguments.index,
+                        prune=arguments.prune,
+                    )
 
-            case FTPCommand.UPLOAD:
-                await ftp_loader.upload(arguments.src, arguments.dst)
+                case FTPCommand.UPLOAD:
+                    await ftp_loader.upload(arguments.src, arguments.dst)
     except pydantic.ValidationError as err:
         logger.error("Failed to load and set configuration.")
         logger.error(err)
@@ -0,0 +1,291 @@
+# -*- coding: utf-8 -*-
+
+# Copyright 2025 (c) Vladislav Punko <iam.vlad.punko@gmail.com>
+
+import asyncio
+import ftplib
+import socket
+import time
+import typing
+
+from pyftpkit import metrics
+from pyftpkit._ftp import _set_socket_options
+
+__all__ = ["AsyncFTP"]
+
+_CHUNK_SIZE: typing.Final[int] = 1_048_576  # 1 MB
+
+
+class AsyncFTP:
+    """FTP client that runs the control and data channels on the event loop.
+
+    The interface mirrors the subset of ftplib.FTP used by the library, and
+    server replies raise the ftplib exception classes, so callers handle both
+    clients alike. Only passive transfers are supported.
+
+    A command interrupted before its reply has been read completely, by a
+    timeout, a cancellation or any other error, closes the connection, since
+    its reply would otherwise be taken for the reply to the next command.
+    """
+
+    encoding: str = "utf-8"
+
+    def __init__(self) -> None:
+        self._reader: asyncio.StreamReader | None = None
+        self._writer: asyncio.StreamWriter | None = None
+        self._host: str = ""
+        self._af: int = socket.AF_INET
+        self._timeout: float | None = None
+        self._features: frozenset[str] | None = None
+
+        # Round trip of the latest command, used to route work between servers.
+        self.rtt: float | None = None
+
+    @property
+    def closed(self) -> bool:
+        """Checks whether the control connection has been closed."""
+        return self._writer is None or self._writer.is_closing()
+
+    async def connect(self, host: str, port: int = 21, timeout: float = 30) -> str:
+        """Establishes a new control connection.
+
+        Parameters
+        ----------
+        host : str
+            Host name for a connection.
+
+        port : int, default=21
+            Port number for a connection.
+
+        timeout : float, default=30
+            Timeout in seconds for every network operation.
+
+        Returns
+        -------
+        str
+            Server welcome message.
+        """
+        self._timeout = timeout or None
+
+        self._reader, self._writer = await asyncio.wait_for(
+            asyncio.open_connection(host, port), self._timeout
+        )
+
+        sock = self._writer.get_extra_info("socket")
+        _set_socket_options(sock)
+
+        self._af = sock.family
+        self._host = self._writer.get_extra_info("peername")[0]
+
+        return await self.getresp()
+
+    async def _readline(self) -> str:
+        """Reads one line of a server reply without the line terminator."""
+        if self._reader is None:
+            raise ftplib.error_proto("FTP control connection is not open.")
+
+        line = await asyncio.wait_for(self._reader.readline(), self._timeout)
+        if not line:
+            raise EOFError("FTP server closed the control connection.")
+
+        return line.decode(self.encoding, "surrogateescape").rstrip("\r\n")
+
+    async def getresp(self) -> str:
+        """Reads a complete, possibly multiline, reply and checks its status.
+
+        Raises
+        ------
+        ftplib.Error
+            The matching ftplib exception for 4xx, 5xx and malformed replies.
+        """
+        resp = await self._readline()
+
+        if resp[3:4] == "-":
+            # Multiline replies end with the same code followed by a space.
+            code = resp[:3]
+            lines = [resp]
+            while True:
+                line = await self._readline()
+                lines.append(line)
+                if line[:3] == code and line[3:4] != "-":
+                    break
+            resp = "\n".join(lines)
+
+        match resp[:1]:
+            case "1" | "2" | "3":
+                return resp
+            case "4":
+                raise ftplib.error_temp(resp)
+            case "5":
+                raise ftplib.error_perm(resp)
+            case _:
+                raise ftplib.error_proto(resp)
+
+    async def voidresp(self) -> str:
+        """Expects a 2xx reply."""
+        resp = await self.getresp()
+        if resp[:1] != "2":
+            raise ftplib.error_reply(resp)
+
+        return resp
+
+    async def sendcmd(self, cmd: str) -> str:
+        """Sends a command and returns the reply."""
+        if self._writer is None:
+            raise ftplib.error_proto("FTP control connection is not open.")
+
+        if any(c in cmd for c in "\r\n"):
+            raise ValueError("an illegal newline character should not be contained")
+
+        started = time.perf_counter()
+        try:
+            self._writer.write(cmd.encode(self.encoding) + b"\r\n")
+            await asyncio.wait_for(self._writer.drain(), self._timeout)
+
+            return await self.getresp()
+        except (ftplib.error_temp, ftplib.error_perm):
+            raise  # the reply has been read completely
+        except BaseException:
+            await self.close()
+            raise
+        finally:
+            # Only the verb is reported, arguments may carry credentials.
+            self.rtt = time.perf_counter() - started
+            metrics.observe(
+                "ftp_command_seconds", self.rtt, command=cmd.split(" ", 1)[0].upper()
+            )
+
+    async def voidcmd(self, cmd: str) -> str:
+        """Sends a command and expects a 2xx reply."""
+        resp = await self.sendcmd(cmd)
+        if resp[:1] != "2":
+            raise ftplib.error_reply(resp)
+
+        return resp
+
+    async def login(self, user: str = "anonymous", passwd: str = "") -> str:
+        """Logs in with the given credentials."""
+        resp = await self.sendcmd(f"USER {user!s}")
+        if resp[:1] == "3":
+            resp = await self.sendcmd(f"PASS {passwd!s}")
+        if resp[:1] == "3":
+            resp = await self.sendcmd("ACCT ")
+        if resp[:1] != "2":
+            raise ftplib.error_reply(resp)
+
+        return resp
+
+    async def supports(self, feature: str) -> bool:
+        """Checks whether the server advertises a feature in its FEAT reply."""
+        if self._features is None:
+            try:
+                reply = await self.sendcmd("FEAT")
+            except ftplib.error_perm:
+                reply = ""
+
+            self._features = frozenset(
+                line.split(maxsplit=1)[0].upper()
+                for line in reply.splitlines()[1:-1]
+                if line.strip()
+            )
+
+        return feature.upper() in self._features
+
+    async def cwd(self, dirname: str) -> str:
+        """Changes the working directory."""
+        return await self.voidcmd(f"CWD {dirname!s}")
+
+    async def mkd(self, dirname: str) -> str:
+        """Creates a directory and returns the reply."""
+        return await self.voidcmd(f"MKD {dirname!s}")
+
+    async def rmd(self, dirname: str) -> str:
+        """Removes a directory."""
+        return await self.voidcmd(f"RMD {dirname!s}")
+
+    async def delete(self, filename: str) -> str:
+        """Deletes a file."""
+        resp = await self.sendcmd(f"DELE {filename!s}")
+        if resp[:3] not in ("250", "200"):
+            raise ftplib.error_reply(resp)
+
+        return resp
+
+    async def _open_data_connection(
+        self,
+    ) -> tuple[asyncio.StreamReader, asyncio.StreamWriter]:
+        """Negotiates a passive data connection and connects to it."""
+        if self._af == socket.AF_INET:
+            # The advertised address is ignored in favor of the control peer,
+            # just like ftplib does by default.
+            _, port = ftplib.parse227(await self.sendcmd("PASV"))
+            host = self._host
+        else:
+            host, port = ftplib.parse229(await self.sendcmd("EPSV"), (self._host,))
+
+        reader, writer = await asyncio.wait_for(
+            asyncio.open_connection(host, port), self._timeout
+        )
+        _set_socket_options(writer.get_extra_info("socket"))
+
+        return reader, writer
+
+    async def retrbinary(
+        self,
+        cmd: str,
+        callback: typing.Callable[[bytes], typing.Any],
+        blocksize: int = _CHUNK_SIZE,
+    ) -> str:
+        """Retrieves data in binary mode and feeds every chunk to the callback."""
+        await self.voidcmd("TYPE I")
+
+        try:
+            reader, writer = await self._open_data_connection()
+            try:
+                resp = await self.sendcmd(cmd)
+                # Some servers send a 200 reply before the 150 one.
+                if resp[:1] == "2":
+                    resp = await self.getresp()
+                if resp[:1] != "1":
+                    raise ftplib.error_reply(resp)
+
+                while True:
+                    chunk = await asyncio.wait_for(
+                        reader.read(blocksize), self._timeout
+                    )
+                    if not chunk:
+                        break
+                    callback(chunk)
+            finally:
+                writer.close()
+                try:
+                    await writer.wait_closed()
+                except OSError:
+                    pass
+
+            return await self.voidresp()
+        except (ftplib.error_temp, ftplib.error_perm):
+            raise  # the reply has been read completely
+        except BaseException:
+            # The final reply of the transfer is still pending.
+            await self.close()
+            raise
+
+    async def quit(self) -> str:
+        """Ends the session politely and closes the connection."""
+        try:
+            return await self.voidcmd("QUIT")
+        finally:
+            await self.close()
+
+    async def close(self) -> None:
+        """Closes the control connection without notifying the server."""
+        writer, self._writer, self._reader = self._writer, None, None
+        if writer is None:
+            return None
+
+        writer.close()
+        try:
+            await writer.wait_closed()
+        except OSError:
+            pass
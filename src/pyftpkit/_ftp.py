@@ -5,8 +5,11 @@
 import ftplib
 import socket
 import struct
+import time
 import typing
 
+from pyftpkit import metrics
+
 __all__ = ["FTP"]
 
 _BUFFER_SIZE: typing.Final[int] = 1_048_576  # 1 MB
@@ -39,6 +42,11 @@ def _set_socket_options(sock: socket.socket) -> None:
 class FTP(ftplib.FTP):
     """FTP subclass that applies custom socket settings after connecting."""
 
+    _features: frozenset[str] | None = None
+
+    # Round trip of the latest command, used to route work between servers.
+    rtt: float | None = None
+
     def connect(
         self,
         host: str = "",
@@ -73,3 +81,62 @@ class FTP(ftplib.FTP):
             _set_socket_options(self.sock)
 
         return welcome
+
+    @property
+    def closed(self) -> bool:
+        """Checks whether the control connection has been closed."""
+        return self.sock is None
+
+    def sendcmd(self, cmd: str) -> str:
+        """Sends a command and returns the reply, timing the round trip."""
+        started = time.perf_counter()
+        try:
+            return super().sendcmd(cmd)
+        finally:
+            # Only the verb is reported, arguments may carry credentials.
+            self.rtt = time.perf_counter() - started
+            metrics.observe(
+                "ftp_command_seconds", self.rtt, command=cmd.split(" ", 1)[0].upper()
+            )
+
+    def voidcmd(self, cmd: str) -> str:
+        """Sends a command and expects a 2xx reply, timing the round trip."""
+        started = time.perf_counter()
+        try:
+            return super().voidcmd(cmd)
+        finally:
+            self.rtt = time.perf_counter() - started
+            metrics.observe(
+                "ftp_command_seconds", self.rtt, command=cmd.split(" ", 1)[0].upper()
+            )
+
+    def supports(self, feature: str) -> bool:
+        """Checks whether the server advertises a feature in its FEAT reply.
+
+        The reply is requested once per connection and cached afterwards.
+
+        Parameters
+        ----------
+        feature : str
+            Feature name such as MLST or REST.
+
+        Returns
+        -------
+        bool
+            True if the server supports the feature and False otherwise.
+        """
+        if self._features is None:
+            try:
+                reply = self.sendcmd("FEAT")
+            except ftplib.error_perm:
+                # Servers predating RFC 2389 reject the command altogether.
+                reply = ""
+
+            # Feature lines are indented and enclosed by the status lines.
+            self._features = frozenset(
+                line.split(maxsplit=1)[0].upper()
+                for line in reply.splitlines()[1:-1]
+                if line.strip()
+            )
+
+        return feature.upper() in self._features
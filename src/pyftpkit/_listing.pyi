@@ -0,0 +1,40 @@
+# -*- coding: utf-8 -*-
+
+# Copyright 2025 (c) Vladislav Punko <iam.vlad.punko@gmail.com>
+
+import typing
+
+__all__: list[str] = ["Listing", "parse_listing"]
+
+class Listing:
+    @property
+    def names(self) -> typing.List[str]:
+        """Entry names."""
+        ...
+
+    @property
+    def types(self) -> bytes:
+        """One type code per entry: d, f, l or ?."""
+        ...
+
+    @property
+    def sizes(self) -> typing.List[int]:
+        """Entry sizes in bytes or -1 if unknown."""
+        ...
+
+    @property
+    def mtimes(self) -> typing.List[int]:
+        """Modification times in seconds since the epoch or -1 if unknown."""
+        ...
+
+    def __len__(self) -> int:
+        """Returns the number of entries."""
+        ...
+
+def parse_listing(
+    buffer: bytes,
+    format: typing.Literal["auto", "unix", "mlsd", "dos"] = "auto",
+    encoding: str = "utf-8",
+) -> Listing:
+    """Parses a raw LIST or MLSD response into columns."""
+    ...
@@ -0,0 +1,85 @@
+// -*- coding: utf-8 -*-
+
+// Copyright 2025 (c) Vladislav Punko <iam.vlad.punko@gmail.com>
+
+#include <ctime>
+#include <string>
+#include <string_view>
+
+#include <pybind11/pybind11.h>
+
+#include "listing_parser.h"
+
+namespace py = pybind11;
+
+namespace {
+
+// Columns are converted to Python objects once, so reading an attribute never
+// copies the listing again.
+struct PyListing {
+    py::list names;
+    py::bytes types;
+    py::list sizes;
+    py::list mtimes;
+
+    size_t
+    Size() const
+    {
+        return names.size();
+    }
+};
+
+PyListing
+ParseListing(const py::bytes &buffer, const std::string &format, const std::string &encoding)
+{
+    pyftpkit::ListingFormat listing_format = pyftpkit::ParseListingFormat(format);
+
+    char *data = nullptr;
+    Py_ssize_t size = 0;
+    if (PyBytes_AsStringAndSize(buffer.ptr(), &data, &size) != 0) {
+        throw py::error_already_set();
+    }
+
+    // Bytes objects are immutable, so the buffer stays valid without the lock.
+    pyftpkit::Listing listing;
+    {
+        py::gil_scoped_release release;
+        listing = pyftpkit::ParseListing({data, static_cast<size_t>(size)},
+                                         listing_format,
+                                         static_cast<std::int64_t>(std::time(nullptr)));
+    }
+
+    PyListing result;
+    result.types = py::bytes(listing.types);
+
+    for (size_t i = 0; i < listing.Size(); ++i) {
+        // Undecodable bytes are preserved the same way os.fsdecode() does.
+        auto name = py::reinterpret_steal<py::object>(PyUnicode_Decode(
+            listing.names[i].data(), static_cast<Py_ssize_t>(listing.names[i].size()),
+            encoding.c_str(), "surrogateescape"));
+        if (!name) {
+            throw py::error_already_set();
+        }
+
+        result.names.append(name);
+        result.sizes.append(listing.sizes[i]);
+        result.mtimes.append(listing.mtimes[i]);
+    }
+
+    return result;
+}
+
+} // namespace
+
+PYBIND11_MODULE(_listing, m) {
+    m.doc() = "Fast parser of FTP directory listings.";
+
+    py::class_<PyListing>(m, "Listing")
+        .def_readonly("names", &PyListing::names, "Entry names.")
+        .def_readonly("types", &PyListing::types, "One type code per entry: d, f, l or ?.")
+        .def_readonly("sizes", &PyListing::sizes, "Entry sizes in bytes or -1 if unknown.")
+        .def_readonly("mtimes", &PyListing::mtimes, "Modification times in seconds since the epoch or -1 if unknown.")
+        .def("__len__", &PyListing::Size, "Returns the number of entries.");
+
+    m.def("parse_listing", &ParseListing, py::arg("buffer"), py::arg("format") = "auto", py::arg("encoding") = "utf-8", "Parses a raw LIST or MLSD response into columns.");
+}
@@ -0,0 +1,490 @@
+// -*- coding: utf-8 -*-
+
+// Copyright 2025 (c) Vladislav Punko <iam.vlad.punko@gmail.com>
+
+#include <array>
+#include <cctype>
+#include <limits>
+#include <stdexcept>
+
+#include "listing_parser.h"
+
+namespace pyftpkit {
+
+namespace {
+
+constexpr std::int64_t kSecondsPerDay = 86400;
+
+bool
+IsSpace(char c)
+{
+    return c == ' ' || c == '\t';
+}
+
+bool
+IsDigit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+bool
+EqualsIgnoreCase(std::string_view lhs, std::string_view rhs)
+{
+    if (lhs.size() != rhs.size()) {
+        return false;
+    }
+
+    for (size_t i = 0; i < lhs.size(); ++i) {
+        if (std::tolower(static_cast<unsigned char>(lhs[i])) !=
+            std::tolower(static_cast<unsigned char>(rhs[i]))) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool
+ParseNumber(std::string_view text, std::int64_t &value)
+{
+    if (text.empty()) {
+        return false;
+    }
+
+    value = 0;
+    for (char c : text) {
+        if (!IsDigit(c) || value > (std::numeric_limits<std::int64_t>::max() - 9) / 10) {
+            return false;
+        }
+        value = value * 10 + (c - '0');
+    }
+
+    return true;
+}
+
+// Days between the epoch and a date of the proleptic Gregorian calendar.
+std::int64_t
+DaysFromCivil(std::int64_t year, unsigned month, unsigned day)
+{
+    year -= month <= 2;
+    const std::int64_t era = (year >= 0 ? year : year - 399) / 400;
+    const auto yoe = static_cast<unsigned>(year - era * 400);
+    const unsigned doy = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+
+    return era * 146097 + static_cast<std::int64_t>(doe) - 719468;
+}
+
+std::int64_t
+YearOf(std::int64_t time)
+{
+    std::int64_t year = 1970 + time / (kSecondsPerDay * 365);
+    while (DaysFromCivil(year, 1, 1) * kSecondsPerDay > time) {
+        --year;
+    }
+    while (DaysFromCivil(year + 1, 1, 1) * kSecondsPerDay <= time) {
+        ++year;
+    }
+
+    return year;
+}
+
+int
+ParseMonth(std::string_view text)
+{
+    static constexpr std::array<std::string_view, 12> kMonths = {
+        "jan", "feb", "mar", "apr", "may", "jun",
+        "jul", "aug", "sep", "oct", "nov", "dec",
+    };
+
+    for (size_t i = 0; i < kMonths.size(); ++i) {
+        if (EqualsIgnoreCase(text, kMonths[i])) {
+            return static_cast<int>(i) + 1;
+        }
+    }
+
+    return 0;
+}
+
+// Parses "HH:MM" into seconds since midnight.
+bool
+ParseClock(std::string_view text, std::int64_t &seconds)
+{
+    size_t colon = text.find(':');
+    std::int64_t hours = 0;
+    std::int64_t minutes = 0;
+
+    if (colon == std::string_view::npos || !ParseNumber(text.substr(0, colon), hours) ||
+        !ParseNumber(text.substr(colon + 1), minutes) || hours > 23 || minutes > 59) {
+        return false;
+    }
+    seconds = hours * 3600 + minutes * 60;
+
+    return true;
+}
+
+// Splits a line into whitespace separated fields while remembering where each
+// of them ends, so that the remainder of the line can be taken verbatim.
+class Fields {
+public:
+    explicit Fields(std::string_view line) : line_(line) {}
+
+    bool
+    Next(std::string_view &field)
+    {
+        while (position_ < line_.size() && IsSpace(line_[position_])) {
+            ++position_;
+        }
+        if (position_ == line_.size()) {
+            return false;
+        }
+
+        size_t start = position_;
+        while (position_ < line_.size() && !IsSpace(line_[position_])) {
+            ++position_;
+        }
+        field = line_.substr(start, position_ - start);
+
+        return true;
+    }
+
+    // Everything after the single separator that follows the last field.
+    std::string_view
+    Rest() const
+    {
+        return position_ < line_.size() ? line_.substr(position_ + 1) : std::string_view();
+    }
+
+    // Everything after the whole run of separators that follows the last field.
+    std::string_view
+    RestTrimmed() const
+    {
+        size_t position = position_;
+        while (position < line_.size() && IsSpace(line_[position])) {
+            ++position;
+        }
+
+        return line_.substr(position);
+    }
+
+private:
+    std::string_view line_;
+    size_t position_ = 0;
+};
+
+bool
+IsUnixMode(std::string_view mode)
+{
+    if (mode.size() < 10 || std::string_view("-dlbcpsD").find(mode[0]) == std::string_view::npos) {
+        return false;
+    }
+
+    for (size_t i = 1; i < 10; ++i) {
+        if (std::string_view("rwxsStTlL-").find(mode[i]) == std::string_view::npos) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// drwxr-xr-x   2 owner group   4096 Oct 27 09:12 name
+//
+// The number of columns before the date differs between servers, so the date
+// is located first and the size is taken from the column preceding it. Owners
+// and groups may look like parts of a date themselves, so only a date behind
+// the links, owner and group columns that follows a numeric size is accepted.
+bool
+ParseUnixLine(std::string_view line, std::int64_t now, ListingEntry &entry)
+{
+    Fields fields(line);
+
+    std::string_view mode;
+    if (!fields.Next(mode) || !IsUnixMode(mode)) {
+        return false;
+    }
+
+    switch (mode[0]) {
+        case 'd':
+            entry.type = EntryType::kDirectory;
+            break;
+        case 'l':
+            entry.type = EntryType::kSymlink;
+            break;
+        case '-':
+            entry.type = EntryType::kFile;
+            break;
+        default:
+            entry.type = EntryType::kOther;
+    }
+
+    // Links, owner, group and size come before the date at the very least.
+    constexpr size_t kFirstDateColumn = 4;
+
+    std::array<std::string_view, 3> window;  // the last three columns seen
+    std::string_view previous;
+
+    for (size_t count = 0; fields.Next(window[count % 3]); ++count) {
+        if (count < 2) {
+            continue;
+        }
+
+        std::string_view month = window[(count - 2) % 3];
+        std::string_view day = window[(count - 1) % 3];
+        std::string_view clock = window[count % 3];
+
+        std::int64_t size = 0;
+        std::int64_t dd = 0;
+        int mm = ParseMonth(month);
+        if (count < kFirstDateColumn + 2 || !ParseNumber(previous, size) || mm == 0 ||
+            day.size() > 2 || !ParseNumber(day, dd) || dd < 1 || dd > 31) {
+            previous = month;
+            continue;
+        }
+
+        std::int64_t seconds = 0;
+        std::int64_t year = 0;
+
+        if (ParseClock(clock, seconds)) {
+            // Recent files are listed without a year; a date in the future
+            // belongs to the previous year.
+            year = YearOf(now);
+            if ((DaysFromCivil(year, mm, dd) * kSecondsPerDay + seconds) > now + kSecondsPerDay) {
+                --year;
+            }
+        } else if (clock.size() != 4 || !ParseNumber(clock, year)) {
+            previous = month;
+            continue;
+        }
+
+        entry.name = fields.Rest();
+        entry.size = size;
+        entry.mtime = DaysFromCivil(year, mm, dd) * kSecondsPerDay + seconds;
+
+        if (entry.type == EntryType::kSymlink) {
+            entry.name = entry.name.substr(0, entry.name.find(" -> "));
+        }
+
+        return !entry.name.empty();
+    }
+
+    return false;
+}
+
+// 10-27-23  09:12AM       <DIR>          name
+// 10-27-2023  21:12                 512 name
+bool
+ParseDosLine(std::string_view line, ListingEntry &entry)
+{
+    Fields fields(line);
+
+    std::string_view date;
+    std::string_view clock;
+    std::string_view size;
+    if (!fields.Next(date) || !fields.Next(clock) || !fields.Next(size)) {
+        return false;
+    }
+
+    std::int64_t mm = 0;
+    std::int64_t dd = 0;
+    std::int64_t year = 0;
+    if (date.size() < 8 || (date[2] != '-' && date[2] != '/') || date[5] != date[2] ||
+        !ParseNumber(date.substr(0, 2), mm) || !ParseNumber(date.substr(3, 2), dd) ||
+        !ParseNumber(date.substr(6), year) || mm < 1 || mm > 12 || dd < 1 || dd > 31) {
+        return false;
+    }
+    if (date.size() == 8) {
+        year += year < 70 ? 2000 : 1900;
+    }
+
+    std::int64_t seconds = 0;
+    std::string_view suffix;
+    if (clock.size() > 2 && !IsDigit(clock.back())) {
+        suffix = clock.substr(clock.size() - 2);
+        clock.remove_suffix(2);
+    }
+    if (!ParseClock(clock, seconds)) {
+        return false;
+    }
+    if (!suffix.empty()) {
+        bool pm = EqualsIgnoreCase(suffix, "pm");
+        if (!pm && !EqualsIgnoreCase(suffix, "am")) {
+            return false;
+        }
+        // 12:xxAM is just after midnight and 12:xxPM just after noon.
+        seconds %= 12 * 3600;
+        seconds += pm ? 12 * 3600 : 0;
+    }
+
+    if (EqualsIgnoreCase(size, "<DIR>")) {
+        entry.type = EntryType::kDirectory;
+        entry.size = -1;
+    } else if (ParseNumber(size, entry.size)) {
+        entry.type = EntryType::kFile;
+    } else {
+        return false;
+    }
+
+    entry.name = fields.RestTrimmed();
+    entry.mtime = DaysFromCivil(year, static_cast<unsigned>(mm), static_cast<unsigned>(dd)) *
+                      kSecondsPerDay + seconds;
+
+    return !entry.name.empty();
+}
+
+// type=file;size=512;modify=20231027091500; name
+//
+// Returns false for malformed lines as well as for the cdir and pdir entries.
+bool
+ParseMlsdLine(std::string_view line, ListingEntry &entry)
+{
+    size_t space = line.find(' ');
+    if (space == std::string_view::npos || space + 1 == line.size()) {
+        return false;
+    }
+
+    std::string_view facts = line.substr(0, space);
+    if (!facts.empty() && (facts.back() != ';' || facts.find('=') == std::string_view::npos)) {
+        return false;
+    }
+
+    entry.name = line.substr(space + 1);
+    entry.type = EntryType::kOther;
+    entry.size = -1;
+    entry.mtime = -1;
+
+    while (!facts.empty()) {
+        size_t end = facts.find(';');
+        std::string_view fact = facts.substr(0, end);
+        facts.remove_prefix(end + 1);
+
+        size_t equals = fact.find('=');
+        if (equals == std::string_view::npos) {
+            return false;
+        }
+        std::string_view key = fact.substr(0, equals);
+        std::string_view value = fact.substr(equals + 1);
+
+        if (EqualsIgnoreCase(key, "type")) {
+            if (EqualsIgnoreCase(value, "cdir") || EqualsIgnoreCase(value, "pdir")) {
+                return false;
+            }
+            if (EqualsIgnoreCase(value, "file")) {
+                entry.type = EntryType::kFile;
+            } else if (EqualsIgnoreCase(value, "dir")) {
+                entry.type = EntryType::kDirectory;
+            } else if (EqualsIgnoreCase(value.substr(0, 13), "OS.unix=slink") ||
+                       EqualsIgnoreCase(value, "OS.unix=symlink")) {
+                entry.type = EntryType::kSymlink;
+            }
+        } else if (EqualsIgnoreCase(key, "size")) {
+            if (!ParseNumber(value, entry.size)) {
+                entry.size = -1;
+            }
+        } else if (EqualsIgnoreCase(key, "modify") && value.size() >= 14) {
+            std::int64_t year = 0;
+            std::int64_t mm = 0;
+            std::int64_t dd = 0;
+            std::int64_t hh = 0;
+            std::int64_t mi = 0;
+            std::int64_t ss = 0;
+
+            // Fractions of a second are dropped.
+            if (ParseNumber(value.substr(0, 4), year) && ParseNumber(value.substr(4, 2), mm) &&
+                ParseNumber(value.substr(6, 2), dd) && ParseNumber(value.substr(8, 2), hh) &&
+                ParseNumber(value.substr(10, 2), mi) && ParseNumber(value.substr(12, 2), ss) &&
+                mm >= 1 && mm <= 12 && dd >= 1 && dd <= 31) {
+                entry.mtime = DaysFromCivil(year, static_cast<unsigned>(mm), static_cast<unsigned>(dd)) *
+                                  kSecondsPerDay + hh * 3600 + mi * 60 + ss;
+            }
+        }
+    }
+
+    return true;
+}
+
+} // namespace
+
+void
+Listing::Append(const ListingEntry &entry)
+{
+    names.push_back(entry.name);
+    types.push_back(static_cast<char>(entry.type));
+    sizes.push_back(entry.size);
+    mtimes.push_back(entry.mtime);
+}
+
+size_t
+Listing::Size() const
+{
+    return names.size();
+}
+
+Listing
+ParseListing(std::string_view buffer, ListingFormat format, std::int64_t now)
+{
+    Listing listing;
+
+    size_t start = 0;
+    while (start < buffer.size()) {
+        size_t end = buffer.find('\n', start);
+        if (end == std::string_view::npos) {
+            end = buffer.size();
+        }
+
+        std::string_view line = buffer.substr(start, end - start);
+        start = end + 1;
+
+        if (!line.empty() && line.back() == '\r') {
+            line.remove_suffix(1);
+        }
+
+        ListingEntry entry{};
+        bool parsed = false;
+
+        switch (format) {
+            case ListingFormat::kAuto:
+                // Bare MLSD names are only accepted when the format is known,
+                // since any indented line would look like one.
+                parsed = ParseUnixLine(line, now, entry) || ParseDosLine(line, entry) ||
+                         (!line.empty() && line.front() != ' ' && ParseMlsdLine(line, entry));
+                break;
+            case ListingFormat::kUnix:
+                parsed = ParseUnixLine(line, now, entry);
+                break;
+            case ListingFormat::kMlsd:
+                parsed = ParseMlsdLine(line, entry);
+                break;
+            case ListingFormat::kDos:
+                parsed = ParseDosLine(line, entry);
+                break;
+        }
+
+        if (parsed && entry.name != "." && entry.name != "..") {
+            listing.Append(entry);
+        }
+    }
+
+    return listing;
+}
+
+ListingFormat
+ParseListingFormat(std::string_view name)
+{
+    if (name == "auto") {
+        return ListingFormat::kAuto;
+    }
+    if (name == "unix") {
+        return ListingFormat::kUnix;
+    }
+    if (name == "mlsd") {
+        return ListingFormat::kMlsd;
+    }
+    if (name == "dos") {
+        return ListingFormat::kDos;
+    }
+
+    throw std::invalid_argument("Listing format must be one of: auto, unix, mlsd, dos.");
+}
+
+} // namespace pyftpkit
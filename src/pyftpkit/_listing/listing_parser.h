@@ -0,0 +1,57 @@
+// -*- coding: utf-8 -*-
+
+// Copyright 2025 (c) Vladislav Punko <iam.vlad.punko@gmail.com>
+
+#ifndef LISTING_PARSER_H_
+#define LISTING_PARSER_H_
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace pyftpkit {
+
+enum class EntryType : char {
+    kFile = 'f',
+    kDirectory = 'd',
+    kSymlink = 'l',
+    kOther = '?',
+};
+
+enum class ListingFormat {
+    kAuto,  // detected line by line
+    kUnix,
+    kMlsd,
+    kDos,
+};
+
+struct ListingEntry {
+    std::string_view name;
+    EntryType type;
+    std::int64_t size;   // bytes or -1 if unknown
+    std::int64_t mtime;  // seconds since the epoch or -1 if unknown
+};
+
+// Columns of a parsed listing. Names are views into the parsed buffer, so they
+// are only valid for as long as the buffer itself.
+struct Listing {
+    std::vector<std::string_view> names;
+    std::string types;
+    std::vector<std::int64_t> sizes;
+    std::vector<std::int64_t> mtimes;
+
+    void Append(const ListingEntry &entry);
+    size_t Size() const;
+};
+
+// Parses a raw LIST or MLSD response. Malformed lines, totals and the entries
+// of the directory itself and of its parent are skipped. Unix listings omit
+// the year of recent files, which is inferred relative to the given time.
+Listing ParseListing(std::string_view buffer, ListingFormat format, std::int64_t now);
+
+ListingFormat ParseListingFormat(std::string_view name);
+
+} // namespace pyftpkit
+
+#endif
@@ -0,0 +1,197 @@
+# -*- coding: utf-8 -*-
+
+# Copyright 2025 (c) Vladislav Punko <iam.vlad.punko@gmail.com>
+
+"""Packing of many small files into tar archives built during the upload.
+
+Every small file costs a few control commands and a data connection of its own,
+which dominates the transfer of trees with many tiny files. Packed uploads send
+such files as a handful of archive segments instead, and a hook on the server
+unpacks them. Archives are produced on demand while cURL reads them, so nothing
+is staged on the local disk.
+"""
+
+import io
+import os
+import pathlib
+import tarfile
+import typing
+
+from pyftpkit._pathtrie import PathTrie
+
+__all__ = [
+    "MANIFEST_NAME",
+    "Member",
+    "PACK_THRESHOLD",
+    "SEGMENT_SIZE",
+    "TarStream",
+    "collect",
+    "manifest",
+    "pack",
+    "segment_name",
+]
+
+# Files below this size are packed, larger ones are uploaded as they are.
+PACK_THRESHOLD: typing.Final[int] = 16_384  # 16 KB
+
+# Upper bound of the archived size of one segment.
+SEGMENT_SIZE: typing.Final[int] = 67_108_864  # 64 MB
+
+# Name of the manifest uploaded next to the segments once all of them are sent.
+MANIFEST_NAME: typing.Final[str] = ".pyftpkit-pack.trie"
+
+# Size of the chunks read from the packed files.
+_CHUNK_SIZE: typing.Final[int] = 65_536  # 64 KB
+
+
+class Member(typing.NamedTuple):
+    """Local file and its path relative to the uploaded directory."""
+
+    path: pathlib.Path
+    name: str
+    size: int
+    mtime: int
+
+
+def segment_name(index: int) -> str:
+    """Returns the remote name of an archive segment."""
+    return f".pyftpkit-pack-{index:05d}.tar"
+
+
+def _header(member: Member) -> bytes:
+    """Builds the tar header blocks of a member, long names included."""
+    info = tarfile.TarInfo(member.name)
+    info.size = member.size
+    info.mtime = member.mtime
+    info.mode = 0o644
+
+    return info.tobuf(tarfile.PAX_FORMAT, "utf-8", "surrogateescape")
+
+
+def _archived_size(member: Member) -> int:
+    """Returns the number of bytes a member takes in an archive."""
+    return len(_header(member)) + member.size + -member.size % tarfile.BLOCKSIZE
+
+
+def collect(root: pathlib.Path) -> list[Member]:
+    """Lists every file below a local directory in a stable order."""
+    members: list[Member] = []
+    for dirpath, dirnames, filenames in os.walk(root):
+        dirnames.sort()
+        for filename in sorted(filenames):
+            path = pathlib.Path(dirpath, filename)
+            stat = path.stat()
+            members.append(
+                Member(
+                    path,
+                    path.relative_to(root).as_posix(),
+                    stat.st_size,
+                    int(stat.st_mtime),
+                )
+            )
+
+    return members
+
+
+class TarStream:
+    """Reads an uncompressed tar archive of local files as it is being built.
+
+    The size of the archive is known in advance from the sizes of its members,
+    which lets the server learn the length of the upload. Should a file change
+    its size in the meantime, reading fails instead of producing an archive of
+    another length.
+    """
+
+    def __init__(self, members: typing.Sequence[Member]) -> None:
+        self.members = members
+        self.size: int = sum(map(_archived_size, members)) + 2 * tarfile.BLOCKSIZE
+
+        self._blocks: typing.Generator[bytes, None, None] | None = None
+        self._buffer = bytearray()
+
+    def __str__(self) -> str:
+        return f"archive of {len(self.members)} files"
+
+    def _generate(self) -> typing.Generator[bytes, None, None]:
+        """Yields the archive piece by piece."""
+        for member in self.members:
+            yield _header(member)
+
+            remaining = member.size
+            with io.open(member.path, mode="rb") as stream:
+                while remaining:
+                    chunk = stream.read(min(remaining, _CHUNK_SIZE))
+                    if not chunk:
+                        raise OSError(f"File shrank while being packed: {member.path}")
+
+                    remaining -= len(chunk)
+                    yield chunk
+
+            if padding := -member.size % tarfile.BLOCKSIZE:
+                yield bytes(padding)
+
+        # Two empty blocks mark the end of the archive.
+        yield bytes(2 * tarfile.BLOCKSIZE)
+
+    def read(self, size: int) -> bytes:
+        """Returns up to the given number of bytes, an empty result at the end."""
+        if self._blocks is None:
+            self._blocks = self._generate()
+
+        while len(self._buffer) < size:
+            chunk = next(self._blocks, None)
+            if chunk is None:
+                break
+
+            self._buffer += chunk
+
+        data = bytes(self._buffer[:size])
+        del self._buffer[:size]
+
+        return data
+
+    def rewind(self) -> None:
+        """Starts the archive over, closing any file still being read."""
+        if self._blocks is not None:
+            self._blocks.close()
+
+        self._blocks = None
+        self._buffer.clear()
+
+
+def pack(
+    members: typing.Iterable[Member], segment_size: int = SEGMENT_SIZE
+) -> list[TarStream]:
+    """Splits files into archive segments of at most the given size.
+
+    Files keep their order, so neighbours in the tree end up in the same segment.
+    A file larger than a segment gets a segment of its own.
+    """
+    segments: list[list[Member]] = []
+    size: int = 0
+    for member in members:
+        archived = _archived_size(member)
+        if not segments or size + archived > segment_size:
+            segments.append([])
+            size = 0
+
+        segments[-1].append(member)
+        size += archived
+
+    return [TarStream(segment) for segment in segments]
+
+
+def manifest(segments: typing.Sequence[TarStream]) -> PathTrie:
+    """Records the members of every segment for the unpacking on the server.
+
+    Each member is stored below the name of its segment with its size and its
+    modification time, so a preorder walk of the trie lists every segment
+    followed by the files it contains.
+    """
+    trie = PathTrie()
+    for index, segment in enumerate(segments):
+        name = segment_name(index)
+        for member in segment.members:
+            trie.set_metadata(f"{name}/{member.name}", member.size, member.mtime)
+
+    return trie
@@ -2,9 +2,10 @@
 
 # Copyright 2025 (c) Vladislav Punko <iam.vlad.punko@gmail.com>
 
+import os
 import typing
 
-__all__: list[str] = ["PathTrieIterator", "PathTrie"]
+__all__: list[str] = ["PathTrieIterator", "PathTrieBatchIterator", "PathTrieLevelIterator", "PathTrie"]
 
 class PathTrieIterator:
     def __iter__(self) -> "PathTrieIterator":
@@ -15,11 +16,43 @@ class PathTrieIterator:
         """Returns the next unique path string."""
         ...
 
+    def next_batch(self, size: int) -> typing.List[str]:
+        """Returns a list of up to size next unique paths."""
+        ...
+
+class PathTrieBatchIterator:
+    def __iter__(self) -> "PathTrieBatchIterator":
+        """Returns self as an iterator."""
+        ...
+
+    def __next__(self) -> typing.List[str]:
+        """Returns a list with the next batch of unique paths."""
+        ...
+
+class PathTrieLevelIterator:
+    def __iter__(self) -> "PathTrieLevelIterator":
+        """Returns self as an iterator."""
+        ...
+
+    def __next__(self) -> typing.List[str]:
+        """Returns all unique paths of the next depth."""
+        ...
+
 class PathTrie:
-    def __iter__(self) -> typing.Iterator[str]:
+    @typing.overload
+    def __iter__(self) -> PathTrieIterator:
         """Returns all unique paths as a generator of strings."""
         ...
 
+    @typing.overload
+    def __iter__(self, batch_size: int) -> PathTrieBatchIterator:
+        """Returns all unique paths as a generator of lists of strings."""
+        ...
+
+    def levels(self) -> typing.Iterator[typing.List[str]]:
+        """Returns unique paths grouped by depth as a generator of lists."""
+        ...
+
     def clear(self) -> None:
         """Clears the entire trie."""
         ...
@@ -28,6 +61,61 @@ class PathTrie:
         """Inserts a single path into a trie."""
         ...
 
+    @typing.overload
+    def insert_many(self, buffer: bytes, *, threads: int = 1) -> None:
+        """Inserts normalized paths from a newline or NUL separated buffer."""
+        ...
+
+    @typing.overload
+    def insert_many(self, paths: typing.Iterable[str | bytes | os.PathLike[str]], *, threads: int = 1) -> None:
+        """Inserts normalized paths from an iterable without holding the GIL."""
+        ...
+
     def get_all_unique_paths(self) -> typing.List[str]:
         """Returns all unique paths as a list of strings."""
         ...
+
+    def contains(self, path: str) -> bool:
+        """Checks whether a path is present in the trie."""
+        ...
+
+    def __contains__(self, path: str) -> bool:
+        """Checks whether a path is present in the trie."""
+        ...
+
+    def longest_existing_prefix(self, path: str) -> typing.Optional[str]:
+        """Returns the longest prefix of a path present in the trie or None."""
+        ...
+
+    def missing_from(self, other: "PathTrie") -> typing.List[str]:
+        """Returns the paths of the trie absent from another trie, parents first."""
+        ...
+
+    def add_ref(self, path: str, count: int = 1) -> int:
+        """Adds references to a path, inserting it if needed, and returns the new count."""
+        ...
+
+    def release(self, path: str, count: int = 1) -> int:
+        """Drops references from a path and returns the remaining count."""
+        ...
+
+    def ref_count(self, path: str) -> int:
+        """Returns the reference count of a path, zero for unknown paths."""
+        ...
+
+    def set_metadata(self, path: str, size: int = -1, mtime: int = -1, *, is_dir: bool = False) -> None:
+        """Attaches a size and a modification time to a path, inserting it if needed."""
+        ...
+
+    def metadata(self, path: str) -> typing.Optional[typing.Tuple[int, int, bool]]:
+        """Returns the size, modification time and directory flag of a path or None."""
+        ...
+
+    def save(self, path: str | bytes | os.PathLike[str]) -> None:
+        """Writes the trie to a snapshot file."""
+        ...
+
+    @staticmethod
+    def load(path: str | bytes | os.PathLike[str], mmap: bool = True) -> "PathTrie":
+        """Loads a trie from a snapshot file, memory-mapping it by default."""
+        ...
@@ -0,0 +1,132 @@
+// -*- coding: utf-8 -*-
+
+// Copyright 2025 (c) Vladislav Punko <iam.vlad.punko@gmail.com>
+
+#ifndef ARENA_H_
+#define ARENA_H_
+
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace pyftpkit {
+
+// Stores objects in fixed-size contiguous blocks addressed by a dense index.
+// Blocks are never released on reset, so refilling the arena after a reset
+// performs no allocations until the previous high-water mark is exceeded.
+template <typename T, size_t kBlockSize = 1 << 12>
+class BlockArena {
+    static_assert(std::is_trivially_destructible_v<T>,
+                  "arena elements are discarded without running destructors");
+    static_assert((kBlockSize & (kBlockSize - 1)) == 0,
+                  "block size must be a power of two");
+
+public:
+    size_t
+    Emplace(const T &value)
+    {
+        if (size_ == blocks_.size() * kBlockSize) {
+            blocks_.push_back(std::make_unique<T[]>(kBlockSize));
+        }
+        (*this)[size_] = value;
+
+        return size_++;
+    }
+
+    T &
+    operator[](size_t index)
+    {
+        return blocks_[index / kBlockSize][index % kBlockSize];
+    }
+
+    const T &
+    operator[](size_t index) const
+    {
+        return blocks_[index / kBlockSize][index % kBlockSize];
+    }
+
+    size_t
+    Size() const
+    {
+        return size_;
+    }
+
+    void
+    Reset()
+    {
+        size_ = 0;  // keep all blocks for reuse
+    }
+
+private:
+    std::vector<std::unique_ptr<T[]>> blocks_;
+    size_t size_ = 0;
+};
+
+// Copies strings into large character blocks and hands out views that remain
+// valid until the arena is reset.
+class StringArena {
+public:
+    std::string_view
+    Store(std::string_view str)
+    {
+        if (str.size() > kBlockSize) {
+            // Oversized strings get a dedicated block so that regular blocks
+            // are not wasted.
+            detached_.push_back(std::make_unique<char[]>(str.size()));
+            std::memcpy(detached_.back().get(), str.data(), str.size());
+
+            return {detached_.back().get(), str.size()};
+        }
+
+        if (blocks_.empty() || offset_ + str.size() > kBlockSize) {
+            if (blocks_.empty() || ++block_ == blocks_.size()) {
+                block_ = blocks_.size();
+                blocks_.push_back(std::make_unique<char[]>(kBlockSize));
+            }
+            offset_ = 0;
+        }
+
+        char *data = blocks_[block_].get() + offset_;
+        std::memcpy(data, str.data(), str.size());
+        offset_ += str.size();
+
+        return {data, str.size()};
+    }
+
+    // Takes over every block of another arena, so views handed out by it stay
+    // valid for the lifetime of this one.
+    void
+    Absorb(StringArena &other)
+    {
+        for (auto &blocks : {&other.blocks_, &other.detached_}) {
+            for (auto &block : *blocks) {
+                detached_.push_back(std::move(block));
+            }
+            blocks->clear();
+        }
+        other.Reset();
+    }
+
+    void
+    Reset()
+    {
+        detached_.clear();
+        block_ = 0;
+        offset_ = 0;
+    }
+
+private:
+    static constexpr size_t kBlockSize = 1 << 16;
+
+    std::vector<std::unique_ptr<char[]>> blocks_;
+    std::vector<std::unique_ptr<char[]>> detached_;  // released on reset
+    size_t block_ = 0;
+    size_t offset_ = 0;
+};
+
+} // namespace pyftpkit
+
+#endif
@@ -0,0 +1,190 @@
+// -*- coding: utf-8 -*-
+
+// Copyright 2025 (c) Vladislav Punko <iam.vlad.punko@gmail.com>
+
+#ifndef CHILD_TABLE_H_
+#define CHILD_TABLE_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace pyftpkit {
+
+using NodeIndex = std::uint32_t;
+
+// Open-addressing hash table that maps a (parent, name) edge to a child index
+// for the whole trie at once. Slots are stamped with a generation number, so
+// the table is emptied in constant time by bumping the current generation.
+class ChildTable {
+public:
+    static constexpr NodeIndex kNotFound = UINT32_MAX;
+
+    // The predicate receives a candidate child index and reports whether its
+    // name matches the searched one; full hashes are compared first.
+    template <typename Equal>
+    NodeIndex
+    Find(NodeIndex parent, size_t hash, Equal equal) const
+    {
+        if (slots_.empty()) {
+            return kNotFound;
+        }
+
+        const size_t mask = slots_.size() - 1;
+        for (size_t i = Mix(parent, hash) & mask;; i = (i + 1) & mask) {
+            const Slot &slot = slots_[i];
+
+            if (slot.generation != generation_) {
+                return kNotFound;
+            }
+            if (slot.parent == parent && slot.hash == hash && equal(slot.child)) {
+                return slot.child;
+            }
+        }
+    }
+
+    void
+    Insert(NodeIndex parent, NodeIndex child, size_t hash)
+    {
+        if ((size_ + 1) * kLoadFactorDen > slots_.size() * kLoadFactorNum) {
+            Grow();
+        }
+        Place({parent, child, generation_, hash});
+        ++size_;
+    }
+
+    void
+    Reset()
+    {
+        size_ = 0;
+
+        // Wraparound would resurrect stale slots, so wipe them for real once
+        // every four billion resets.
+        if (++generation_ == 0) {
+            for (auto &slot : slots_) {
+                slot.generation = 0;
+            }
+            generation_ = 1;
+        }
+    }
+
+private:
+    struct Slot {
+        NodeIndex parent;
+        NodeIndex child;
+        std::uint32_t generation;
+        size_t hash;
+    };
+
+    static constexpr size_t kInitialSlots = 1 << 10;
+    static constexpr size_t kLoadFactorNum = 7;  // keep the table at most 70% full
+    static constexpr size_t kLoadFactorDen = 10;
+
+    std::vector<Slot> slots_;
+    size_t size_ = 0;
+    std::uint32_t generation_ = 1;  // zero-initialized slots are always empty
+
+    static size_t
+    Mix(NodeIndex parent, size_t hash)
+    {
+        return hash ^ (static_cast<size_t>(parent) * 0x9e3779b97f4a7c15ULL);
+    }
+
+    void
+    Place(const Slot &entry)
+    {
+        const size_t mask = slots_.size() - 1;
+        for (size_t i = Mix(entry.parent, entry.hash) & mask;; i = (i + 1) & mask) {
+            if (slots_[i].generation != generation_) {
+                slots_[i] = entry;
+
+                return;
+            }
+        }
+    }
+
+    void
+    Grow()
+    {
+        std::vector<Slot> slots(slots_.empty() ? kInitialSlots : slots_.size() * 2);
+        slots.swap(slots_);
+
+        for (const auto &slot : slots) {
+            if (slot.generation == generation_) {
+                Place(slot);
+            }
+        }
+    }
+};
+
+// Keeps the child lists of all nodes in one contiguous vector. Every list gets
+// a power-of-two sized range, and ranges released by growing lists are
+// recycled through per-size free lists.
+class ChildPool {
+public:
+    NodeIndex *
+    Data(std::uint32_t offset)
+    {
+        return slots_.data() + offset;
+    }
+
+    const NodeIndex *
+    Data(std::uint32_t offset) const
+    {
+        return slots_.data() + offset;
+    }
+
+    // Moves a full list of the given size into a range twice as large and
+    // returns its new offset.
+    std::uint32_t
+    Grow(std::uint32_t offset, std::uint32_t size)
+    {
+        unsigned order = 0;
+        while ((std::uint32_t{1} << order) < size) {
+            ++order;
+        }
+
+        std::uint32_t grown = Allocate(size == 0 ? 0 : order + 1);
+        if (size > 0) {
+            std::memcpy(Data(grown), Data(offset), size * sizeof(NodeIndex));
+            free_[order].push_back(offset);
+        }
+
+        return grown;
+    }
+
+    void
+    Reset()
+    {
+        slots_.clear();
+        for (auto &offsets : free_) {
+            offsets.clear();
+        }
+    }
+
+private:
+    std::vector<NodeIndex> slots_;
+    std::array<std::vector<std::uint32_t>, 32> free_;
+
+    std::uint32_t
+    Allocate(unsigned order)
+    {
+        if (!free_[order].empty()) {
+            std::uint32_t offset = free_[order].back();
+            free_[order].pop_back();
+
+            return offset;
+        }
+
+        auto offset = static_cast<std::uint32_t>(slots_.size());
+        slots_.resize(slots_.size() + (size_t{1} << order));
+
+        return offset;
+    }
+};
+
+} // namespace pyftpkit
+
+#endif
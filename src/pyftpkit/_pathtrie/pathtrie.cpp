@@ -2,74 +2,472 @@
 
 // Copyright 2025 (c) Vladislav Punko <iam.vlad.punko@gmail.com>
 
+#include <algorithm>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <limits>
+#include <stdexcept>
 #include <string_view>
+#include <thread>
+#include <utility>
 
 #include "pathtrie.h"
 
 namespace pyftpkit {
 
-PathTrie::PathTrie() : root_(std::make_unique<TrieNode>()) {}
+namespace {
+
+// Runs the task once per thread index and rethrows the first failure only
+// after every thread has been joined.
+template <typename Task>
+void
+RunParallel(size_t threads, Task task)
+{
+    std::vector<std::exception_ptr> errors(threads);
+    std::vector<std::thread> workers;
+    workers.reserve(threads);
+
+    auto join = [&workers]() {
+        for (auto &worker : workers) {
+            worker.join();
+        }
+    };
+
+    try {
+        for (size_t i = 0; i < threads; ++i) {
+            workers.emplace_back([&task, &errors, i]() {
+                try {
+                    task(i);
+                } catch (...) {
+                    errors[i] = std::current_exception();
+                }
+            });
+        }
+    } catch (...) {
+        join();
+        throw;
+    }
+    join();
+
+    for (const auto &error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+}
+
+// Normalized paths produced by one thread for one shard.
+struct Shard {
+    std::string data;
+    std::vector<size_t> ends;
+};
+
+} // namespace
+
+PathTrie::PathTrie()
+{
+    nodes_.Emplace({{}, kNullNode, 0, 0, 0});  // root
+}
 
 void
 PathTrie::Clear()
 {
-    root_ = std::make_unique<TrieNode>();
+    // All storage is handed back to the arenas in constant time and reused
+    // by subsequent insertions.
+    nodes_.Reset();
+    children_.Reset();
+    unsorted_.clear();
+    names_.Reset();
+    lookup_.Reset();
+    snapshot_.reset();
+    refs_.clear();
+    metadata_.clear();
+
+    nodes_.Emplace({{}, kNullNode, 0, 0, 0});
+    ++version_;
+}
+
+NodeIndex
+PathTrie::InsertPath(NodeIndex node, std::string_view path, bool stored)
+{
+    // Arena blocks never move, so the parent reference survives emplacing
+    // the child below.
+    TrieNode &parent = nodes_[node];
+
+    const bool wide = parent.size > kSmallFanout;
+
+    size_t hash = 0;
+    size_t position = parent.size;
+
+    if (wide) {
+        hash = std::hash<std::string_view>{}(path);
+
+        NodeIndex child = lookup_.Find(node, hash, [&](NodeIndex index) {
+            return nodes_[index].name == path;
+        });
+        if (child != ChildTable::kNotFound) {
+            return child;
+        }
+    } else {
+        // Narrow nodes are searched in place, which beats hashing for the
+        // handful of children most directories have.
+        const NodeIndex *children = children_.Data(parent.children);
+        const NodeIndex *it = std::lower_bound(
+            children, children + parent.size, path,
+            [this](NodeIndex index, std::string_view name) {
+                return nodes_[index].name < name;
+            });
+
+        if (it != children + parent.size && nodes_[*it].name == path) {
+            return *it;
+        }
+        position = it - children;
+    }
+
+    auto child = static_cast<NodeIndex>(
+        nodes_.Emplace({stored ? path : names_.Store(path), node, 0, 0, 0}));
+
+    // Lists are full whenever their size is zero or a power of two.
+    if ((parent.size & (parent.size - 1)) == 0) {
+        parent.children = children_.Grow(parent.children, parent.size);
+    }
+
+    NodeIndex *children = children_.Data(parent.children);
+    std::memmove(children + position + 1,
+                 children + position,
+                 (parent.size - position) * sizeof(NodeIndex));
+    children[position] = child;
+
+    // Wide nodes collect children unsorted rather than shifting the whole
+    // list on every insertion.
+    if (!wide) {
+        ++parent.sorted;
+    } else if (parent.sorted == parent.size) {
+        unsorted_.push_back(node);
+    }
+    ++parent.size;
+
+    if (wide) {
+        lookup_.Insert(node, child, hash);
+    } else if (parent.size > kSmallFanout) {
+        // The node outgrew linear searches, so index all of its children.
+        for (size_t i = 0; i < parent.size; ++i) {
+            std::string_view name = nodes_[children[i]].name;
+            lookup_.Insert(node, children[i], std::hash<std::string_view>{}(name));
+        }
+    }
+
+    ++version_;
+
+    return child;
+}
+
+void
+PathTrie::SortChildren() const
+{
+    auto less = [this](NodeIndex lhs, NodeIndex rhs) {
+        return nodes_[lhs].name < nodes_[rhs].name;
+    };
+
+    for (NodeIndex node : unsorted_) {
+        TrieNode &parent = nodes_[node];
+        NodeIndex *children = children_.Data(parent.children);
+
+        std::sort(children + parent.sorted, children + parent.size, less);
+        std::inplace_merge(children, children + parent.sorted, children + parent.size, less);
+
+        parent.sorted = parent.size;
+    }
+    unsorted_.clear();
 }
 
-TrieNode *
-PathTrie::InsertPath(TrieNode *node, const std::string &path)
+void
+PathTrie::Thaw()
 {
-    auto [it, inserted] = node->children.emplace(path, nullptr);
-    if (inserted) {
-        it->second = std::make_unique<TrieNode>();
+    if (!snapshot_) {
+        return;
     }
 
-    return it->second.get();
+    // Snapshot nodes come in breadth-first order, so every parent has already
+    // been copied by the time its children are reached.
+    std::unique_ptr<TrieSnapshot> snapshot = std::move(snapshot_);
+
+    std::vector<NodeIndex> copies(snapshot->Size());
+    copies[kRoot] = kRoot;
+
+    for (size_t i = 0; i < snapshot->Size(); ++i) {
+        const SnapshotNode &node = snapshot->Node(i);
+
+        for (size_t j = 0; j < node.child_count; ++j) {
+            NodeIndex child = node.first_child + j;
+            copies[child] = InsertPath(copies[i], snapshot->Name(child));
+        }
+    }
+
+    if (snapshot->HasMetadata()) {
+        metadata_.resize(nodes_.Size());
+        for (size_t i = 0; i < snapshot->Size(); ++i) {
+            metadata_[copies[i]] = snapshot->Metadata(i);
+        }
+    }
+
+    ++version_;
 }
 
 void
-PathTrie::Insert(const std::string &path)
+PathTrie::Insert(std::string_view path)
+{
+    InsertNode(path);
+}
+
+NodeIndex
+PathTrie::InsertNode(std::string_view path)
 {
     if (path.empty()) {
-        return;
+        return kRoot;
     }
 
-    TrieNode *node = root_.get();
+    Thaw();
+
+    NodeIndex node = kRoot;
 
-    static const std::string sep(1, kUnixSep);
+    static constexpr std::string_view sep(&kUnixSep, 1);
     if (path.front() == kUnixSep) {
         node = InsertPath(node, sep);
     }
 
-    for (const auto &part : SplitPath(path, kUnixSep)) {
-        if (part.empty() || part == ".") {  // "." and ".."
+    // Walk the components in place; a node is only allocated when the lookup
+    // of an existing child fails.
+    size_t start = 0;
+    while (start < path.size()) {
+        size_t end = path.find(kUnixSep, start);
+        if (end == std::string_view::npos) {
+            end = path.size();
+        }
+
+        std::string_view part = path.substr(start, end - start);
+        start = end + 1;
+
+        if (part.empty() || part == ".") {
             continue;
         }
-        node = InsertPath(node, std::string(part));
+
+        // Parent references are resolved against the trie itself. Climbing out
+        // of the top of a relative path lands on the root directory, and the
+        // root directory is its own parent.
+        if (part == "..") {
+            if (node == kRoot) {
+                node = InsertPath(node, sep);
+            } else if (nodes_[node].parent != kRoot) {
+                node = nodes_[node].parent;
+            } else if (nodes_[node].name != sep) {
+                node = kRoot;
+            }
+
+            continue;
+        }
+
+        node = InsertPath(node, part);
     }
+
+    return node;
 }
 
-std::vector<std::string_view>
-PathTrie::SplitPath(const std::string &str, const char &sep)
+void
+PathTrie::NormalizePath(std::string_view path, std::string &buffer)
 {
-    std::vector<std::string_view> parts;
-    parts.reserve(kPathsReserve);  // avoid reallocations for small splits
+    // Mirror os.path.normpath() on POSIX systems: collapse separators, drop "."
+    // and resolve ".." lexically without ever climbing above the root.
+    buffer.clear();
+
+    if (!path.empty() && path.front() == kUnixSep) {
+        buffer.push_back(kUnixSep);
+    }
+    const size_t floor = buffer.size();
+    size_t depth = 0;  // components that a following ".." is allowed to remove
 
     size_t start = 0;
-    size_t end = 0;
+    while (start < path.size()) {
+        size_t end = path.find(kUnixSep, start);
+        if (end == std::string_view::npos) {
+            end = path.size();
+        }
 
-    while ((end = str.find(sep, start)) != std::string_view::npos) {
-        if (end > start) {
-            parts.emplace_back(std::string_view(str.data() + start, end - start));
+        std::string_view part = path.substr(start, end - start);
+        start = end + 1;
+
+        if (part.empty() || part == ".") {
+            continue;
+        }
+
+        if (part == "..") {
+            if (depth > 0) {
+                size_t pos = buffer.rfind(kUnixSep);
+                buffer.resize(pos == std::string::npos || pos < floor ? floor : pos);
+                --depth;
+
+                continue;
+            }
+
+            // Leading references are kept for relative paths only.
+            if (floor > 0) {
+                continue;
+            }
+        } else {
+            ++depth;
+        }
+
+        if (buffer.size() > floor) {
+            buffer.push_back(kUnixSep);
+        }
+        buffer.append(part);
+    }
+}
+
+void
+PathTrie::InsertMany(const std::vector<std::string_view> &paths, size_t threads)
+{
+    Thaw();
+
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    threads = std::min(threads, paths.size() / kParallelThreshold);
+
+    if (threads <= 1) {
+        std::string buffer;
+        buffer.reserve(kPathsReserve);
+
+        for (const auto &path : paths) {
+            NormalizePath(path, buffer);
+            Insert(buffer);
+        }
+
+        return;
+    }
+
+    // Each thread normalizes a contiguous slice of the input and files every
+    // path under the shard owning its top-level component.
+    std::vector<std::vector<Shard>> shards(threads, std::vector<Shard>(threads));
+    RunParallel(threads, [&](size_t thread) {
+        std::string buffer;
+        buffer.reserve(kPathsReserve);
+
+        const size_t begin = paths.size() * thread / threads;
+        const size_t end = paths.size() * (thread + 1) / threads;
+
+        for (size_t i = begin; i < end; ++i) {
+            NormalizePath(paths[i], buffer);
+            if (buffer.empty()) {
+                continue;
+            }
+
+            std::string_view key(buffer);
+            key.remove_prefix(key.front() == kUnixSep ? 1 : 0);
+            key = key.substr(0, key.find(kUnixSep));
+
+            Shard &shard = shards[thread][std::hash<std::string_view>{}(key) % threads];
+            shard.data.append(buffer);
+            shard.ends.push_back(shard.data.size());
+        }
+    });
+
+    // Shards share nothing below their top-level components, so each one is
+    // built into a private trie without any locking.
+    std::vector<PathTrie> tries(threads);
+    RunParallel(threads, [&](size_t index) {
+        for (const auto &row : shards) {
+            const Shard &shard = row[index];
+
+            size_t start = 0;
+            for (size_t end : shard.ends) {
+                tries[index].Insert(std::string_view(shard.data).substr(start, end - start));
+                start = end;
+            }
+        }
+    });
+
+    auto trie = tries.begin();
+    if (nodes_.Size() == 1) {
+        // An empty trie simply takes over the storage of the first shard.
+        std::swap(nodes_, trie->nodes_);
+        std::swap(children_, trie->children_);
+        std::swap(unsorted_, trie->unsorted_);
+        std::swap(names_, trie->names_);
+        std::swap(lookup_, trie->lookup_);
+        ++version_;
+        ++trie;
+    }
+
+    for (; trie != tries.end(); ++trie) {
+        Merge(std::move(*trie));
+    }
+}
+
+void
+PathTrie::InsertBuffer(std::string_view buffer, size_t threads)
+{
+    Thaw();
+
+    std::vector<std::string_view> paths;
+    std::string normpath;
+    normpath.reserve(kPathsReserve);
+
+    size_t start = 0;
+    while (start < buffer.size()) {
+        size_t end = buffer.find_first_of(std::string_view("\n\0", 2), start);
+        if (end == std::string_view::npos) {
+            end = buffer.size();
+        }
+
+        // Sequential inserts stream through the buffer without collecting views.
+        if (threads == 1) {
+            NormalizePath(buffer.substr(start, end - start), normpath);
+            Insert(normpath);
+        } else {
+            paths.push_back(buffer.substr(start, end - start));
         }
         start = end + 1;
     }
 
-    if (start < str.size()) {
-        parts.emplace_back(std::string_view(str.data() + start, str.size() - start));
+    if (!paths.empty()) {
+        InsertMany(paths, threads);
+    }
+}
+
+void
+PathTrie::Merge(PathTrie &&other)
+{
+    if (&other == this) {
+        return;
     }
 
-    return parts;
+    Thaw();
+
+    // Names of the merged nodes are shared with the other trie instead of being
+    // copied once again, unless they live in a mapping about to be released.
+    names_.Absorb(other.names_);
+    MergeNode(kRoot, other, kRoot);
+
+    other.Clear();
+}
+
+void
+PathTrie::MergeNode(NodeIndex node, const PathTrie &other, NodeIndex source)
+{
+    const bool stored = !other.snapshot_;
+
+    for (size_t i = 0; i < other.ChildCount(source); ++i) {
+        NodeIndex child = other.Child(source, i);
+        NodeIndex copy = InsertPath(node, other.Name(child), stored);
+
+        // Metadata of the merged trie wins, as it is usually the newer one.
+        if (const NodeMetadata *metadata = other.Metadata(child)) {
+            StoreMetadata(copy, *metadata);
+        }
+        MergeNode(copy, other, child);
+    }
 }
 
 std::vector<std::string>
@@ -81,29 +479,347 @@ PathTrie::GetAllUniquePaths() const
     std::string buffer;
     buffer.reserve(kPathsReserve);
 
-    CollectPaths(root_.get(), buffer, paths);
+    SortChildren();
+    CollectPaths(kRoot, buffer, paths);
+
+    return paths;
+}
+
+NodeIndex
+PathTrie::FindChild(NodeIndex node, std::string_view name) const
+{
+    if (snapshot_) {
+        // Mapped child lists are contiguous runs ordered by name.
+        const SnapshotNode &parent = snapshot_->Node(node);
+
+        NodeIndex first = parent.first_child;
+        NodeIndex last = first + parent.child_count;
+        while (first < last) {
+            NodeIndex middle = first + (last - first) / 2;
+
+            if (snapshot_->Name(middle) < name) {
+                first = middle + 1;
+            } else {
+                last = middle;
+            }
+        }
+
+        bool found = first != parent.first_child + parent.child_count &&
+                     snapshot_->Name(first) == name;
+
+        return found ? first : kNullNode;
+    }
+
+    const TrieNode &parent = nodes_[node];
+
+    if (parent.size > kSmallFanout) {
+        return lookup_.Find(node, std::hash<std::string_view>{}(name), [&](NodeIndex index) {
+            return nodes_[index].name == name;
+        });
+    }
+
+    // Narrow nodes are always fully sorted.
+    const NodeIndex *children = children_.Data(parent.children);
+    const NodeIndex *it = std::lower_bound(
+        children, children + parent.size, name,
+        [this](NodeIndex index, std::string_view name) {
+            return nodes_[index].name < name;
+        });
+
+    return it != children + parent.size && nodes_[*it].name == name ? *it : kNullNode;
+}
+
+std::pair<NodeIndex, bool>
+PathTrie::Descend(std::string_view path) const
+{
+    // Returns the deepest node the path leads to and whether every component
+    // of the path could be followed.
+    NodeIndex node = kRoot;
+
+    static constexpr std::string_view sep(&kUnixSep, 1);
+    if (!path.empty() && path.front() == kUnixSep) {
+        node = FindChild(node, sep);
+        if (node == kNullNode) {
+            return {kRoot, false};
+        }
+    }
+
+    size_t start = 0;
+    while (start < path.size()) {
+        size_t end = path.find(kUnixSep, start);
+        if (end == std::string_view::npos) {
+            end = path.size();
+        }
+
+        std::string_view part = path.substr(start, end - start);
+        start = end + 1;
+
+        if (part.empty() || part == ".") {
+            continue;
+        }
+
+        NodeIndex child = kNullNode;
+        if (part == "..") {
+            // Same resolution rules as in Insert().
+            if (node == kRoot) {
+                child = FindChild(node, sep);
+            } else if (Parent(node) != kRoot) {
+                child = Parent(node);
+            } else {
+                child = Name(node) != sep ? kRoot : node;
+            }
+        } else {
+            child = FindChild(node, part);
+        }
+
+        if (child == kNullNode) {
+            return {node, false};
+        }
+        node = child;
+    }
+
+    return {node, true};
+}
+
+bool
+PathTrie::Contains(std::string_view path) const
+{
+    auto [node, complete] = Descend(path);
+
+    return complete && node != kRoot;
+}
+
+std::uint32_t
+PathTrie::AddRef(std::string_view path, std::uint32_t count)
+{
+    NodeIndex node = InsertNode(path);
+    if (node == kRoot) {
+        throw std::invalid_argument("reference counts need a non-empty path");
+    }
+
+    if (node >= refs_.size()) {
+        refs_.resize(nodes_.Size(), 0);
+    }
+
+    if (refs_[node] > std::numeric_limits<std::uint32_t>::max() - count) {
+        throw std::overflow_error("reference count of the path overflows");
+    }
+
+    return refs_[node] += count;
+}
+
+std::uint32_t
+PathTrie::Release(std::string_view path, std::uint32_t count)
+{
+    auto [node, complete] = Descend(path);
+    if (!complete || node == kRoot || node >= refs_.size() || refs_[node] < count) {
+        throw std::invalid_argument("path holds fewer references than released");
+    }
+
+    return refs_[node] -= count;
+}
+
+std::uint32_t
+PathTrie::RefCount(std::string_view path) const
+{
+    auto [node, complete] = Descend(path);
+    if (!complete || node == kRoot || node >= refs_.size()) {
+        return 0;
+    }
+
+    return refs_[node];
+}
+
+void
+PathTrie::StoreMetadata(NodeIndex node, const NodeMetadata &metadata)
+{
+    if (node >= metadata_.size()) {
+        metadata_.resize(nodes_.Size());
+    }
+
+    metadata_[node] = metadata;
+    metadata_[node].flags |= NodeMetadata::kPresent;
+}
+
+void
+PathTrie::SetMetadata(std::string_view path, const NodeMetadata &metadata)
+{
+    NodeIndex node = InsertNode(path);
+    if (node == kRoot) {
+        throw std::invalid_argument("metadata needs a non-empty path");
+    }
+
+    StoreMetadata(node, metadata);
+}
+
+std::optional<NodeMetadata>
+PathTrie::GetMetadata(std::string_view path) const
+{
+    auto [node, complete] = Descend(path);
+    if (!complete || node == kRoot) {
+        return std::nullopt;
+    }
+
+    const NodeMetadata *metadata = Metadata(node);
+    if (metadata == nullptr) {
+        return std::nullopt;
+    }
+
+    return *metadata;
+}
+
+std::optional<std::string>
+PathTrie::LongestExistingPrefix(std::string_view path) const
+{
+    NodeIndex node = Descend(path).first;
+    if (node == kRoot) {
+        return std::nullopt;
+    }
+
+    // Rebuild the canonical spelling of the prefix from the node upwards.
+    std::vector<std::string_view> names;
+    for (; node != kRoot; node = Parent(node)) {
+        names.push_back(Name(node));
+    }
+
+    std::string prefix;
+    for (auto it = names.rbegin(); it != names.rend(); ++it) {
+        if (!prefix.empty() && prefix.back() != kUnixSep) {
+            prefix.push_back(kUnixSep);
+        }
+        prefix.append(*it);
+    }
+
+    return prefix;
+}
+
+std::vector<std::string>
+PathTrie::MissingFrom(const PathTrie &other) const
+{
+    std::vector<std::string> paths;
+
+    std::string buffer;
+    buffer.reserve(kPathsReserve);
+
+    SortChildren();
+    CollectMissing(kRoot, other, kRoot, buffer, paths);
 
     return paths;
 }
 
 void
-PathTrie::CollectPaths(const TrieNode *node,
+PathTrie::CollectMissing(NodeIndex node,
+                         const PathTrie &other,
+                         NodeIndex source,
+                         std::string &buffer,
+                         std::vector<std::string> &paths) const
+{
+    for (size_t i = 0; i < ChildCount(node); ++i) {
+        NodeIndex child = Child(node, i);
+        size_t size = buffer.size();
+
+        if (!buffer.empty() && buffer.back() != kUnixSep) {
+            buffer.push_back(kUnixSep);
+        }
+        buffer.append(Name(child));
+
+        // Once a node is missing, so is its whole subtree.
+        NodeIndex match = other.FindChild(source, Name(child));
+        if (match == kNullNode) {
+            paths.push_back(buffer);
+            CollectPaths(child, buffer, paths);
+        } else {
+            CollectMissing(child, other, match, buffer, paths);
+        }
+
+        buffer.resize(size);
+    }
+}
+
+void
+PathTrie::CollectPaths(NodeIndex node,
                        std::string &buffer,
                        std::vector<std::string> &paths) const
 {
-    for (const auto &[name, child] : node->children) {
+    for (size_t i = 0; i < ChildCount(node); ++i) {
+        NodeIndex child = Child(node, i);
         size_t size = buffer.size();
 
         if (!buffer.empty() && buffer.back() != kUnixSep) {
             buffer.push_back(kUnixSep);
         }
-        buffer.append(name);
+        buffer.append(Name(child));
 
         paths.push_back(buffer);
-        CollectPaths(child.get(), buffer, paths);
+        CollectPaths(child, buffer, paths);
 
         buffer.resize(size);
     }
 }
 
+SnapshotLayout
+PathTrie::Layout() const
+{
+    SortChildren();
+
+    // Lay the nodes out breadth-first: the children of the node at position i
+    // are appended as one run while it is visited.
+    std::vector<std::pair<NodeIndex, NodeIndex>> order{{kRoot, kNullNode}};
+    SnapshotLayout layout;
+    auto &[nodes, metadata, strings] = layout;
+
+    const bool with_metadata = HasMetadata();
+
+    for (size_t i = 0; i < order.size(); ++i) {
+        auto [node, parent] = order[i];
+        std::string_view name = Name(node);
+        std::uint32_t count = ChildCount(node);
+
+        if (strings.size() + name.size() > std::numeric_limits<std::uint32_t>::max() ||
+            order.size() + count >= kNullNode) {
+            throw std::overflow_error("PathTrie is too large to be saved.");
+        }
+
+        nodes.push_back({static_cast<std::uint32_t>(strings.size()),
+                         static_cast<std::uint32_t>(name.size()),
+                         parent,
+                         count > 0 ? static_cast<NodeIndex>(order.size()) : 0,
+                         count});
+        strings.append(name);
+
+        if (with_metadata) {
+            const NodeMetadata *record = Metadata(node);
+            metadata.push_back(record ? *record : NodeMetadata{});
+        }
+
+        for (size_t j = 0; j < count; ++j) {
+            order.emplace_back(Child(node, j), static_cast<NodeIndex>(i));
+        }
+    }
+
+    return layout;
+}
+
+void
+PathTrie::Save(const std::string &path) const
+{
+    SnapshotLayout layout = Layout();
+    TrieSnapshot::Write(path, layout.nodes, layout.metadata, layout.strings);
+}
+
+PathTrie
+PathTrie::Load(const std::string &path, bool mmap)
+{
+    PathTrie trie;
+    trie.snapshot_ = std::make_unique<TrieSnapshot>(path, mmap);
+
+    // A snapshot read into memory is copied right away, so the buffer holding
+    // the file is released before the trie is returned.
+    if (!mmap) {
+        trie.Thaw();
+    }
+
+    return trie;
+}
+
 } // namespace pyftpkit
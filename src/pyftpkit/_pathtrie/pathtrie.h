@@ -5,43 +5,171 @@
 #ifndef PATHTRIE_H_
 #define PATHTRIE_H_
 
+#include <cstdint>
 #include <memory>
+#include <optional>
 #include <string>
-#include <unordered_map>
+#include <string_view>
+#include <utility>
 #include <vector>
 
+#include "arena.h"
+#include "child_table.h"
+#include "pathtrie_snapshot.h"
+
 namespace pyftpkit {
 
+// Nodes refer to each other by their position in the node arena and keep
+// their names in the string arena, so a node never owns heap memory. Children
+// are a range of the child pool ordered by name; wide nodes append new
+// children unsorted and restore the order lazily before the next traversal.
 struct TrieNode {
-    std::unordered_map<std::string, std::unique_ptr<TrieNode>> children;
+    std::string_view name;
+    NodeIndex parent;
+    std::uint32_t children;  // offset of the child list in the pool
+    std::uint32_t size;      // number of children
+    std::uint32_t sorted;    // length of the ordered prefix of the child list
 };
 
 // Use the forward declaration for this class and declare it as a friend of the
 // class containing the trie to encapsulate and hide as many attributes as possible.
 class PathTrieIterator;
+class PathTrieLevelIterator;
 
 class PathTrie {
 public:
     PathTrie();
 
     void Clear();
-    void Insert(const std::string &path);
+    void Insert(std::string_view path);
+    void InsertMany(const std::vector<std::string_view> &paths, size_t threads = 1);
+    void InsertBuffer(std::string_view buffer, size_t threads = 1);
+    void Merge(PathTrie &&other);
     std::vector<std::string> GetAllUniquePaths() const;
 
+    // Queries resolve the path the same way insertion does but never create
+    // nodes. MissingFrom() lists the paths of this trie that the other one
+    // lacks, parents before their children.
+    bool Contains(std::string_view path) const;
+    std::optional<std::string> LongestExistingPrefix(std::string_view path) const;
+    std::vector<std::string> MissingFrom(const PathTrie &other) const;
+
+    // Every node carries a reference count for callers tracking outstanding
+    // work per path, e.g. the entries left to delete in a directory. AddRef()
+    // inserts the path when needed, and both return the updated count. Counts
+    // are neither merged nor saved in snapshots.
+    std::uint32_t AddRef(std::string_view path, std::uint32_t count = 1);
+    std::uint32_t Release(std::string_view path, std::uint32_t count = 1);
+    std::uint32_t RefCount(std::string_view path) const;
+
+    // Metadata is attached to single paths, so an index of a remote tree keeps
+    // the size and modification time of every entry next to its path. Unlike
+    // reference counts it is merged and saved in snapshots. SetMetadata()
+    // inserts the path when needed.
+    void SetMetadata(std::string_view path, const NodeMetadata &metadata);
+    std::optional<NodeMetadata> GetMetadata(std::string_view path) const;
+
+    // Snapshots are written in breadth-first order with every child list kept
+    // contiguous, so a mapped trie is traversed in place. The first mutation
+    // of a mapped trie copies it into regular storage. Layout() restores the
+    // order of child lists like any traversal; the layout it returns is then
+    // written without touching the trie.
+    SnapshotLayout Layout() const;
+    void Save(const std::string &path) const;
+    static PathTrie Load(const std::string &path, bool mmap = true);
+
 private:
-    std::unique_ptr<TrieNode> root_;
+    // Ordering of wide nodes is restored by const traversals, which is why the
+    // child lists are mutable.
+    mutable BlockArena<TrieNode> nodes_;
+    mutable ChildPool children_;
+    mutable std::vector<NodeIndex> unsorted_;
+    StringArena names_;
+    ChildTable lookup_;
+    std::unique_ptr<TrieSnapshot> snapshot_;  // set while the trie is mapped
+    std::vector<std::uint32_t> refs_;          // allocated on the first AddRef()
+    std::vector<NodeMetadata> metadata_;       // allocated on the first SetMetadata()
+
+    // Incremented on every structural change to detect stale iterators.
+    std::uint64_t version_ = 0;
+
+    static constexpr NodeIndex kRoot = 0;
+    static constexpr NodeIndex kNullNode = UINT32_MAX;
 
     static constexpr char kUnixSep = '/';
     static constexpr size_t kDepthReserve = 1 << 12;  // estimated average path depth in the trie
     static constexpr size_t kPathsReserve = 1 << 12;  // expected number of unique paths
+    static constexpr size_t kParallelThreshold = 1 << 14;  // minimum paths per thread
+    static constexpr size_t kSmallFanout = 16;  // children searched without hashing
+
+    // Read access that works the same for mapped and regular tries.
+    std::uint32_t
+    ChildCount(NodeIndex node) const
+    {
+        return snapshot_ ? snapshot_->Node(node).child_count : nodes_[node].size;
+    }
+
+    NodeIndex
+    Child(NodeIndex node, size_t position) const
+    {
+        if (snapshot_) {
+            return snapshot_->Node(node).first_child + static_cast<NodeIndex>(position);
+        }
+        return children_.Data(nodes_[node].children)[position];
+    }
+
+    std::string_view
+    Name(NodeIndex node) const
+    {
+        return snapshot_ ? snapshot_->Name(node) : nodes_[node].name;
+    }
+
+    NodeIndex
+    Parent(NodeIndex node) const
+    {
+        return snapshot_ ? snapshot_->Node(node).parent : nodes_[node].parent;
+    }
+
+    bool
+    HasMetadata() const
+    {
+        return snapshot_ ? snapshot_->HasMetadata() : !metadata_.empty();
+    }
+
+    // Returns nullptr for nodes without metadata.
+    const NodeMetadata *
+    Metadata(NodeIndex node) const
+    {
+        const NodeMetadata *metadata = nullptr;
+        if (snapshot_) {
+            metadata = snapshot_->HasMetadata() ? &snapshot_->Metadata(node) : nullptr;
+        } else if (node < metadata_.size()) {
+            metadata = &metadata_[node];
+        }
+
+        return metadata && (metadata->flags & NodeMetadata::kPresent) ? metadata : nullptr;
+    }
 
-    void CollectPaths(const TrieNode *node,
+    void Thaw();
+    void StoreMetadata(NodeIndex node, const NodeMetadata &metadata);
+    NodeIndex FindChild(NodeIndex node, std::string_view name) const;
+    std::pair<NodeIndex, bool> Descend(std::string_view path) const;
+    void CollectMissing(NodeIndex node,
+                        const PathTrie &other,
+                        NodeIndex source,
+                        std::string &buffer,
+                        std::vector<std::string> &paths) const;
+    void CollectPaths(NodeIndex node,
                       std::string &buffer,
                       std::vector<std::string> &paths) const;
-    TrieNode *InsertPath(TrieNode *node, const std::string &path);
-    static std::vector<std::string_view> SplitPath(const std::string &str, const char &sep);
+    NodeIndex InsertNode(std::string_view path);
+    NodeIndex InsertPath(NodeIndex node, std::string_view path, bool stored = false);
+    void SortChildren() const;
+    void MergeNode(NodeIndex node, const PathTrie &other, NodeIndex source);
+    static void NormalizePath(std::string_view path, std::string &buffer);
 
     friend class PathTrieIterator;
+    friend class PathTrieLevelIterator;
 };
 
 } // namespace pyftpkit
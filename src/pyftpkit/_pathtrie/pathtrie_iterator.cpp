@@ -2,7 +2,7 @@
 
 // Copyright 2025 (c) Vladislav Punko <iam.vlad.punko@gmail.com>
 
-#include <pybind11/pybind11.h>
+#include <stdexcept>
 
 #include "pathtrie_iterator.h"
 
@@ -11,12 +11,12 @@ namespace py = pybind11;
 namespace pyftpkit {
 
 PathTrieIterator::PathTrieIterator(const PathTrie &trie)
+    : trie_(&trie), version_(trie.version_)
 {
-    const TrieNode *root = trie.root_.get();
+    trie.SortChildren();
 
-    if (root && !root->children.empty()) {
-        PushFrame(root, "");
-    }
+    buffer_.reserve(PathTrie::kPathsReserve);
+    PushFrame(PathTrie::kRoot);
 }
 
 PathTrieIterator &
@@ -25,65 +25,150 @@ PathTrieIterator::Iter()
     return *this;
 }
 
-std::string
-PathTrieIterator::JoinPath(const std::string &prefix, const std::string &path_part) const
+void
+PathTrieIterator::PushFrame(NodeIndex node)
 {
-    // Skip current directory references.
-    if (path_part == ".") {
-        return prefix;
+    if (trie_->ChildCount(node) > 0) {
+        stack_.push_back({node, 0, buffer_.size()});
     }
+}
+
+bool
+PathTrieIterator::Advance()
+{
+    // Node indices are reused once the trie is cleared, so resuming a walk over
+    // a modified trie would silently mix old and new paths.
+    if (version_ != trie_->version_) {
+        throw std::runtime_error("PathTrie changed during iteration.");
+    }
+
+    while (!stack_.empty()) {
+        auto &top = stack_.back();
+
+        if (top.position == trie_->ChildCount(top.node)) {
+            stack_.pop_back();
 
-    // Handle parent directory reference.
-    if (path_part == "..") {
-        auto pos = prefix.find_last_of(PathTrie::kUnixSep);
-        if (pos == std::string::npos || pos == 0) {
-            return "/";
+            continue;
         }
-        return prefix.substr(0, pos);
+
+        NodeIndex index = trie_->Child(top.node, top.position++);
+
+        // The buffer always holds the path of the last visited node, so it only
+        // has to be cut back to the parent before the next name is appended.
+        buffer_.resize(top.size);
+        if (!buffer_.empty() && buffer_.back() != PathTrie::kUnixSep) {
+            buffer_.push_back(PathTrie::kUnixSep);
+        }
+        buffer_.append(trie_->Name(index));
+
+        PushFrame(index);
+
+        return true;
     }
 
-    if (!prefix.empty() && prefix.back() != PathTrie::kUnixSep) {
-        return prefix + PathTrie::kUnixSep + path_part;
+    return false;
+}
+
+std::string_view
+PathTrieIterator::Path() const
+{
+    return buffer_;
+}
+
+py::str
+PathTrieIterator::Next()
+{
+    if (!Advance()) {
+        throw py::stop_iteration();
     }
 
-    return prefix + path_part;
+    return {buffer_.data(), buffer_.size()};
 }
 
-void
-PathTrieIterator::PushFrame(const TrieNode *node, const std::string &prefix)
+py::list
+PathTrieIterator::NextBatch(size_t size)
 {
-    if (!node->children.empty()) {
-        stack_.push({node, node->children.begin(), node->children.end(), prefix});
+    py::list paths;
+
+    for (size_t i = 0; i < size && Advance(); ++i) {
+        paths.append(py::str(buffer_.data(), buffer_.size()));
     }
+
+    return paths;
 }
 
-std::string
-PathTrieIterator::Next()
+PathTrieBatchIterator::PathTrieBatchIterator(const PathTrie &trie, size_t size)
+    : iterator_(trie), size_(size)
 {
-    while (!stack_.empty()) {
-        auto &top = stack_.top();
+    if (size_ == 0) {
+        throw std::invalid_argument("Batch size must be a positive integer.");
+    }
+}
 
-        if (top.it == top.end) {
-            stack_.pop();
+PathTrieBatchIterator &
+PathTrieBatchIterator::Iter()
+{
+    return *this;
+}
 
-            continue;
-        }
+py::list
+PathTrieBatchIterator::Next()
+{
+    py::list paths = iterator_.NextBatch(size_);
+
+    if (paths.size() == 0) {
+        throw py::stop_iteration();
+    }
+
+    return paths;
+}
+
+PathTrieLevelIterator::PathTrieLevelIterator(const PathTrie &trie)
+    : trie_(&trie), version_(trie.version_), nodes_{PathTrie::kRoot}, paths_{""}
+{
+    trie.SortChildren();
+}
 
-        const auto &path_part = top.it->first;
-        const TrieNode *child = top.it->second.get();
-        ++top.it; // move to the next child
+PathTrieLevelIterator &
+PathTrieLevelIterator::Iter()
+{
+    return *this;
+}
 
-        std::string path = JoinPath(top.prefix, path_part);
-        PushFrame(child, path);
+const std::vector<std::string> &
+PathTrieLevelIterator::Next()
+{
+    if (version_ != trie_->version_) {
+        throw std::runtime_error("PathTrie changed during iteration.");
+    }
 
-        if (path_part != "." && path_part != "..") {
-            return path;
+    std::vector<NodeIndex> nodes;
+    std::vector<std::string> paths;
+
+    for (size_t i = 0; i < nodes_.size(); ++i) {
+        const std::uint32_t count = trie_->ChildCount(nodes_[i]);
+
+        for (size_t j = 0; j < count; ++j) {
+            NodeIndex child = trie_->Child(nodes_[i], j);
+            std::string &path = paths.emplace_back(paths_[i]);
+
+            if (!path.empty() && path.back() != PathTrie::kUnixSep) {
+                path.push_back(PathTrie::kUnixSep);
+            }
+            path.append(trie_->Name(child));
+
+            nodes.push_back(child);
         }
+    }
 
-        return path;
+    if (nodes.empty()) {
+        throw py::stop_iteration();
     }
 
-    throw py::stop_iteration();
+    nodes_.swap(nodes);
+    paths_.swap(paths);
+
+    return paths_;
 }
 
 } // namespace pyftpkit
@@ -5,20 +5,21 @@
 #ifndef PATHTRIE_ITERATOR_H_
 #define PATHTRIE_ITERATOR_H_
 
-#include <memory>
-#include <stack>
+#include <cstdint>
 #include <string>
-#include <unordered_map>
+#include <string_view>
+#include <vector>
+
+#include <pybind11/pybind11.h>
 
 #include "pathtrie.h"
 
 namespace pyftpkit {
 
 struct StackFrame {
-    const TrieNode *node;
-    std::unordered_map<std::string, std::unique_ptr<TrieNode>>::const_iterator it;
-    std::unordered_map<std::string, std::unique_ptr<TrieNode>>::const_iterator end;
-    std::string prefix;
+    NodeIndex node;
+    std::uint32_t position;  // the next child to visit
+    size_t size;             // length of the node path in the shared buffer
 };
 
 class PathTrieIterator {
@@ -26,13 +27,50 @@ public:
     explicit PathTrieIterator(const PathTrie &trie);
 
     PathTrieIterator &Iter();
-    std::string Next();
+    pybind11::str Next();
+    pybind11::list NextBatch(size_t size);
+
+    // Moves to the next path in depth-first preorder and reports whether one
+    // exists; the path itself is exposed through the view.
+    bool Advance();
+    std::string_view Path() const;
+
+private:
+    const PathTrie *trie_;
+    std::uint64_t version_;
+    std::vector<StackFrame> stack_;
+    std::string buffer_;
+
+    void PushFrame(NodeIndex node);
+};
+
+// Yields lists of consecutive paths to amortize the cost of crossing into
+// Python over many paths at once.
+class PathTrieBatchIterator {
+public:
+    PathTrieBatchIterator(const PathTrie &trie, size_t size);
+
+    PathTrieBatchIterator &Iter();
+    pybind11::list Next();
 
 private:
-    std::stack<StackFrame> stack_;
+    PathTrieIterator iterator_;
+    size_t size_;
+};
 
-    std::string JoinPath(const std::string &prefix, const std::string &path_part) const;
-    void PushFrame(const TrieNode *node, const std::string &prefix);
+// Walks the trie level by level and yields all paths of the same depth at once.
+class PathTrieLevelIterator {
+public:
+    explicit PathTrieLevelIterator(const PathTrie &trie);
+
+    PathTrieLevelIterator &Iter();
+    const std::vector<std::string> &Next();
+
+private:
+    const PathTrie *trie_;
+    std::uint64_t version_;
+    std::vector<NodeIndex> nodes_;
+    std::vector<std::string> paths_;
 };
 
 } // namespace pyftpkit
@@ -2,32 +2,229 @@
 
 // Copyright 2025 (c) Vladislav Punko <iam.vlad.punko@gmail.com>
 
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <exception>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 
 #include "pathtrie.h"
 #include "pathtrie_iterator.h"
+#include "pathtrie_snapshot.h"
 
 namespace py = pybind11;
 
+namespace {
+
+// Number of paths converted while holding the interpreter lock before they are
+// handed over to the trie, which keeps memory bounded for huge iterables.
+constexpr size_t kInsertBatchSize = 1 << 16;
+
+std::string_view
+AsPathView(const py::object &path)
+{
+    char *data = nullptr;
+    Py_ssize_t size = 0;
+
+    if (PyUnicode_Check(path.ptr())) {
+        const char *utf8 = PyUnicode_AsUTF8AndSize(path.ptr(), &size);
+        if (utf8 == nullptr) {
+            throw py::error_already_set();
+        }
+
+        return {utf8, static_cast<size_t>(size)};
+    }
+
+    if (PyBytes_AsStringAndSize(path.ptr(), &data, &size) != 0) {
+        throw py::error_already_set();
+    }
+
+    return {data, static_cast<size_t>(size)};
+}
+
+void
+InsertMany(pyftpkit::PathTrie &self, const py::iterable &paths, size_t threads)
+{
+    // Views point into the converted objects, so they are kept alive until
+    // the batch has been inserted.
+    // Parallel builds receive proportionally larger batches to keep every
+    // thread busy between the round trips to the interpreter.
+    const size_t batch_size = kInsertBatchSize * std::max<size_t>(threads, 1);
+
+    std::vector<py::object> objects;
+    std::vector<std::string_view> batch;
+    objects.reserve(batch_size);
+    batch.reserve(batch_size);
+
+    auto flush = [&]() {
+        {
+            py::gil_scoped_release release;
+            self.InsertMany(batch, threads);
+        }
+        batch.clear();
+        objects.clear();
+    };
+
+    for (py::handle item : paths) {
+        // Accept str, bytes and any os.PathLike object just like os.fspath().
+        auto path = py::reinterpret_steal<py::object>(PyOS_FSPath(item.ptr()));
+        if (!path) {
+            throw py::error_already_set();
+        }
+
+        batch.push_back(AsPathView(path));
+        objects.push_back(std::move(path));
+
+        if (batch.size() == batch_size) {
+            flush();
+        }
+    }
+
+    if (!batch.empty()) {
+        flush();
+    }
+}
+
+void
+InsertBuffer(pyftpkit::PathTrie &self, const py::bytes &buffer, size_t threads)
+{
+    // Bytes objects are immutable, so the view stays valid without the lock.
+    std::string_view view = AsPathView(buffer);
+
+    py::gil_scoped_release release;
+    self.InsertBuffer(view, threads);
+}
+
+std::string
+AsFilename(const py::object &path)
+{
+    // Encode the path exactly as the os module does for system calls.
+    PyObject *encoded = nullptr;
+    if (!PyUnicode_FSConverter(path.ptr(), &encoded)) {
+        throw py::error_already_set();
+    }
+
+    return std::string(py::reinterpret_steal<py::bytes>(encoded));
+}
+
+void
+Save(const pyftpkit::PathTrie &self, const py::object &path)
+{
+    std::string filename = AsFilename(path);
+
+    // Laying the snapshot out reorders child lists, which other threads may be
+    // reading, so only the write runs without the lock.
+    pyftpkit::SnapshotLayout layout = self.Layout();
+
+    py::gil_scoped_release release;
+    pyftpkit::TrieSnapshot::Write(filename, layout.nodes, layout.metadata, layout.strings);
+}
+
+void
+SetMetadata(pyftpkit::PathTrie &self,
+            std::string_view path,
+            std::int64_t size,
+            std::int64_t mtime,
+            bool is_dir)
+{
+    pyftpkit::NodeMetadata metadata;
+    metadata.size = size;
+    metadata.mtime = mtime;
+    metadata.flags = is_dir ? pyftpkit::NodeMetadata::kDirectory : 0;
+
+    self.SetMetadata(path, metadata);
+}
+
+std::optional<std::tuple<std::int64_t, std::int64_t, bool>>
+GetMetadata(const pyftpkit::PathTrie &self, std::string_view path)
+{
+    std::optional<pyftpkit::NodeMetadata> metadata = self.GetMetadata(path);
+    if (!metadata) {
+        return std::nullopt;
+    }
+
+    const bool is_dir = (metadata->flags & pyftpkit::NodeMetadata::kDirectory) != 0;
+
+    return std::make_tuple(metadata->size, metadata->mtime, is_dir);
+}
+
+pyftpkit::PathTrie
+Load(const py::object &path, bool mmap)
+{
+    std::string filename = AsFilename(path);
+
+    py::gil_scoped_release release;
+    return pyftpkit::PathTrie::Load(filename, mmap);
+}
+
+} // namespace
+
 PYBIND11_MODULE(_pathtrie, m) {
     m.doc() = "High-performance unique path generator using a trie.";
 
+    py::register_exception_translator([](std::exception_ptr error) {
+        try {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        } catch (const pyftpkit::FileError &e) {
+            errno = e.code().value();
+            PyErr_SetFromErrnoWithFilename(PyExc_OSError, e.Path().c_str());
+        }
+    });
+
     py::class_<pyftpkit::PathTrieIterator>(m, "PathTrieIterator")
         .def("__iter__", &pyftpkit::PathTrieIterator::Iter, py::return_value_policy::reference_internal, "Returns self as an iterator.")
-        .def("__next__", &pyftpkit::PathTrieIterator::Next, "Returns the next unique path string.");
+        .def("__next__", &pyftpkit::PathTrieIterator::Next, "Returns the next unique path string.")
+        .def("next_batch", &pyftpkit::PathTrieIterator::NextBatch, py::arg("size"), "Returns a list of up to size next unique paths.");
+
+    py::class_<pyftpkit::PathTrieBatchIterator>(m, "PathTrieBatchIterator")
+        .def("__iter__", &pyftpkit::PathTrieBatchIterator::Iter, py::return_value_policy::reference_internal, "Returns self as an iterator.")
+        .def("__next__", &pyftpkit::PathTrieBatchIterator::Next, "Returns a list with the next batch of unique paths.");
+
+    py::class_<pyftpkit::PathTrieLevelIterator>(m, "PathTrieLevelIterator")
+        .def("__iter__", &pyftpkit::PathTrieLevelIterator::Iter, py::return_value_policy::reference_internal, "Returns self as an iterator.")
+        .def("__next__", &pyftpkit::PathTrieLevelIterator::Next, "Returns all unique paths of the next depth.");
 
     py::class_<pyftpkit::PathTrie>(m, "PathTrie")
         .def(py::init<>())
-        .def("__iter__", [](pyftpkit::PathTrie &self) {
+        .def("__iter__", [](pyftpkit::PathTrie &self, size_t batch_size) -> py::object {
             // To avoid undefined behavior, ensure that all collected paths
             // remain valid in memory for the entire lifetime of the iterator.
             // By creating a dedicated iterator object, we guarantee that the
             // underlying data persists safely until iteration completes or
             // the generator is destroyed.
-            return pyftpkit::PathTrieIterator(self);
-        }, py::keep_alive<0, 1>(), "Returns all unique paths as a generator of strings.")
+            if (batch_size > 0) {
+                return py::cast(pyftpkit::PathTrieBatchIterator(self, batch_size));
+            }
+            return py::cast(pyftpkit::PathTrieIterator(self));
+        }, py::arg("batch_size") = 0, py::keep_alive<0, 1>(), "Returns all unique paths as a generator of strings or of lists of strings.")
+        .def("levels", [](pyftpkit::PathTrie &self) {
+            return pyftpkit::PathTrieLevelIterator(self);
+        }, py::keep_alive<0, 1>(), "Returns unique paths grouped by depth as a generator of lists.")
         .def("clear", &pyftpkit::PathTrie::Clear, "Clears the entire trie.")
         .def("insert", &pyftpkit::PathTrie::Insert, py::arg("path"), "Inserts a single path into a trie.")
-        .def("get_all_unique_paths", &pyftpkit::PathTrie::GetAllUniquePaths, "Returns all unique paths as a list of strings.");
+        // The bytes overload must be registered first because bytes objects are
+        // iterable as well.
+        .def("insert_many", &InsertBuffer, py::arg("buffer"), py::kw_only(), py::arg("threads") = 1, "Inserts normalized paths from a newline or NUL separated buffer.")
+        .def("insert_many", &InsertMany, py::arg("paths"), py::kw_only(), py::arg("threads") = 1, "Inserts normalized paths from an iterable without holding the GIL.")
+        .def("get_all_unique_paths", &pyftpkit::PathTrie::GetAllUniquePaths, "Returns all unique paths as a list of strings.")
+        .def("contains", &pyftpkit::PathTrie::Contains, py::arg("path"), "Checks whether a path is present in the trie.")
+        .def("__contains__", &pyftpkit::PathTrie::Contains, py::arg("path"), "Checks whether a path is present in the trie.")
+        .def("longest_existing_prefix", &pyftpkit::PathTrie::LongestExistingPrefix, py::arg("path"), "Returns the longest prefix of a path present in the trie or None.")
+        .def("missing_from", &pyftpkit::PathTrie::MissingFrom, py::arg("other"), "Returns the paths of the trie absent from another trie, parents first.")
+        .def("add_ref", &pyftpkit::PathTrie::AddRef, py::arg("path"), py::arg("count") = 1, "Adds references to a path, inserting it if needed, and returns the new count.")
+        .def("release", &pyftpkit::PathTrie::Release, py::arg("path"), py::arg("count") = 1, "Drops references from a path and returns the remaining count.")
+        .def("ref_count", &pyftpkit::PathTrie::RefCount, py::arg("path"), "Returns the reference count of a path, zero for unknown paths.")
+        .def("set_metadata", &SetMetadata, py::arg("path"), py::arg("size") = -1, py::arg("mtime") = -1, py::kw_only(), py::arg("is_dir") = false, "Attaches a size and a modification time to a path, inserting it if needed.")
+        .def("metadata", &GetMetadata, py::arg("path"), "Returns the size, modification time and directory flag of a path or None.")
+        .def("save", &Save, py::arg("path"), "Writes the trie to a snapshot file.")
+        .def_static("load", &Load, py::arg("path"), py::arg("mmap") = true, "Loads a trie from a snapshot file, memory-mapping it by default.");
 }
@@ -0,0 +1,211 @@
+// -*- coding: utf-8 -*-
+
+// Copyright 2025 (c) Vladislav Punko <iam.vlad.punko@gmail.com>
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "pathtrie_snapshot.h"
+
+namespace pyftpkit {
+
+namespace {
+
+[[noreturn]] void
+ThrowSystemError(const std::string &path)
+{
+    throw FileError(errno, path);
+}
+
+} // namespace
+
+TrieSnapshot::TrieSnapshot(const std::string &path, bool mmap)
+{
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        ThrowSystemError(path);
+    }
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        int error = errno;
+        ::close(fd);
+        errno = error;
+        ThrowSystemError(path);
+    }
+    size_ = static_cast<size_t>(st.st_size);
+
+    if (mmap && size_ > 0) {
+        void *data = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        int error = errno;
+        ::close(fd);
+
+        if (data == MAP_FAILED) {
+            errno = error;
+            ThrowSystemError(path);
+        }
+        data_ = static_cast<const char *>(data);
+        mapped_ = true;
+    } else {
+        buffer_.resize(size_);
+
+        size_t offset = 0;
+        while (offset < size_) {
+            ssize_t count = ::read(fd, buffer_.data() + offset, size_ - offset);
+            if (count < 0 && errno == EINTR) {
+                continue;
+            }
+            if (count <= 0) {
+                int error = count < 0 ? errno : EIO;
+                ::close(fd);
+                errno = error;
+                ThrowSystemError(path);
+            }
+            offset += static_cast<size_t>(count);
+        }
+        ::close(fd);
+
+        data_ = buffer_.data();
+    }
+
+    try {
+        Validate();
+    } catch (...) {
+        if (mapped_) {
+            ::munmap(const_cast<char *>(data_), size_);
+        }
+        throw;
+    }
+}
+
+TrieSnapshot::~TrieSnapshot()
+{
+    if (mapped_) {
+        ::munmap(const_cast<char *>(data_), size_);
+    }
+}
+
+void
+TrieSnapshot::Validate()
+{
+    // Everything is checked up front, so traversals of the mapped nodes never
+    // have to guard against corrupted offsets.
+    if (size_ < sizeof(SnapshotHeader)) {
+        throw std::invalid_argument("File is too small to be a PathTrie snapshot.");
+    }
+
+    SnapshotHeader header;
+    std::memcpy(&header, data_, sizeof(header));
+
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0) {
+        throw std::invalid_argument("File is not a PathTrie snapshot.");
+    }
+    if (header.byte_order != kByteOrder) {
+        throw std::invalid_argument("PathTrie snapshot was written with a different byte order.");
+    }
+    if (header.version != kVersion) {
+        throw std::invalid_argument("Unsupported PathTrie snapshot version.");
+    }
+
+    if ((header.flags & ~kMetadataSection) != 0) {
+        throw std::invalid_argument("PathTrie snapshot uses unsupported sections.");
+    }
+
+    // Records of both arrays are laid out back to back, so a node is counted
+    // with all of them at once.
+    size_t record = sizeof(SnapshotNode);
+    if (header.flags & kMetadataSection) {
+        record += sizeof(NodeMetadata);
+    }
+
+    const size_t available = size_ - sizeof(SnapshotHeader);
+    if (header.node_count == 0 || header.node_count > available / record ||
+        header.strings_size != available - header.node_count * record) {
+        throw std::invalid_argument("PathTrie snapshot is truncated or corrupted.");
+    }
+
+    node_count_ = static_cast<size_t>(header.node_count);
+
+    // Metadata comes first to keep its 64-bit fields aligned in the mapping.
+    const char *section = data_ + sizeof(SnapshotHeader);
+    if (header.flags & kMetadataSection) {
+        metadata_ = reinterpret_cast<const NodeMetadata *>(section);
+        section += node_count_ * sizeof(NodeMetadata);
+    }
+    nodes_ = reinterpret_cast<const SnapshotNode *>(section);
+    strings_ = section + node_count_ * sizeof(SnapshotNode);
+
+    for (size_t i = 0; i < node_count_; ++i) {
+        const SnapshotNode &node = nodes_[i];
+
+        // Children always follow their parent in breadth-first order, which
+        // also rules out cycles.
+        bool valid = node.name_offset <= header.strings_size &&
+                     node.name_size <= header.strings_size - node.name_offset &&
+                     (i == 0 ? node.parent == UINT32_MAX : node.parent < i) &&
+                     node.child_count <= node_count_ &&
+                     (node.child_count == 0 ||
+                      (node.first_child > i &&
+                       node.first_child <= node_count_ - node.child_count));
+
+        for (size_t j = 0; valid && j < node.child_count; ++j) {
+            valid = nodes_[node.first_child + j].parent == i;
+        }
+
+        if (!valid) {
+            throw std::invalid_argument("PathTrie snapshot is truncated or corrupted.");
+        }
+    }
+}
+
+void
+TrieSnapshot::Write(const std::string &path,
+                    const std::vector<SnapshotNode> &nodes,
+                    const std::vector<NodeMetadata> &metadata,
+                    std::string_view strings)
+{
+    SnapshotHeader header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.byte_order = kByteOrder;
+    header.node_count = nodes.size();
+    header.strings_size = strings.size();
+    header.flags = metadata.empty() ? 0 : kMetadataSection;
+
+    // Write next to the target and rename afterwards, so an interrupted save
+    // never leaves a truncated snapshot behind.
+    const std::string temporary = path + ".tmp";
+
+    std::FILE *file = std::fopen(temporary.c_str(), "wb");
+    if (file == nullptr) {
+        ThrowSystemError(temporary);
+    }
+
+    bool written = std::fwrite(&header, sizeof(header), 1, file) == 1 &&
+                   (metadata.empty() ||
+                    std::fwrite(metadata.data(), sizeof(NodeMetadata), metadata.size(), file) == metadata.size()) &&
+                   std::fwrite(nodes.data(), sizeof(SnapshotNode), nodes.size(), file) == nodes.size() &&
+                   std::fwrite(strings.data(), 1, strings.size(), file) == strings.size();
+    int error = errno;
+
+    if (std::fclose(file) != 0 && written) {
+        written = false;
+        error = errno;
+    }
+
+    if (!written || std::rename(temporary.c_str(), path.c_str()) != 0) {
+        error = written ? errno : error;
+        std::remove(temporary.c_str());
+        errno = error;
+        ThrowSystemError(path);
+    }
+}
+
+} // namespace pyftpkit
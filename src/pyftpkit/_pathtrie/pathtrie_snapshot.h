@@ -0,0 +1,148 @@
+// -*- coding: utf-8 -*-
+
+// Copyright 2025 (c) Vladislav Punko <iam.vlad.punko@gmail.com>
+
+#ifndef PATHTRIE_SNAPSHOT_H_
+#define PATHTRIE_SNAPSHOT_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <system_error>
+#include <string_view>
+#include <vector>
+
+#include "child_table.h"
+
+namespace pyftpkit {
+
+// On-disk layout: a header, the optional sections announced by its flags, the
+// node array in breadth-first order and a string table. Children of every node
+// are consecutive entries of the node array, so the snapshot can be traversed
+// in place without building any index.
+struct SnapshotHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t byte_order;
+    std::uint64_t node_count;
+    std::uint64_t strings_size;
+    std::uint64_t flags;  // optional sections present in the file
+};
+
+// Attributes attached to a path, e.g. the size and modification time of a
+// remote file. Unknown values are -1 just like in parsed listings. Snapshots
+// store one record per node right after the header when any node has them.
+struct NodeMetadata {
+    static constexpr std::uint32_t kPresent = 1 << 0;
+    static constexpr std::uint32_t kDirectory = 1 << 1;
+
+    std::int64_t size = -1;
+    std::int64_t mtime = -1;
+    std::uint32_t flags = 0;
+    std::uint32_t reserved = 0;
+};
+
+struct SnapshotNode {
+    std::uint32_t name_offset;
+    std::uint32_t name_size;
+    NodeIndex parent;
+    NodeIndex first_child;
+    std::uint32_t child_count;
+};
+
+// Contents of a snapshot built in memory before it is written.
+struct SnapshotLayout {
+    std::vector<SnapshotNode> nodes;
+    std::vector<NodeMetadata> metadata;  // empty or one record per node
+    std::string strings;
+};
+
+// Carries the name of the file an operating system call failed on, so that it
+// can be surfaced to Python as a regular OSError.
+class FileError : public std::system_error {
+public:
+    FileError(int error, const std::string &path)
+        : std::system_error(error, std::generic_category(), path), path_(path)
+    {
+    }
+
+    const std::string &
+    Path() const
+    {
+        return path_;
+    }
+
+private:
+    std::string path_;
+};
+
+class TrieSnapshot {
+public:
+    static constexpr char kMagic[8] = {'P', 'Y', 'F', 'T', 'T', 'R', 'I', 'E'};
+    static constexpr std::uint32_t kVersion = 1;
+    static constexpr std::uint32_t kByteOrder = 0x01020304;
+
+    // Flags of the optional sections.
+    static constexpr std::uint64_t kMetadataSection = 1 << 0;
+
+    // Maps the file into memory when requested or reads it otherwise; both
+    // variants validate the whole layout before it is used.
+    TrieSnapshot(const std::string &path, bool mmap);
+    ~TrieSnapshot();
+
+    TrieSnapshot(const TrieSnapshot &) = delete;
+    TrieSnapshot &operator=(const TrieSnapshot &) = delete;
+
+    // Metadata is either empty or holds one record per node.
+    static void Write(const std::string &path,
+                      const std::vector<SnapshotNode> &nodes,
+                      const std::vector<NodeMetadata> &metadata,
+                      std::string_view strings);
+
+    size_t
+    Size() const
+    {
+        return node_count_;
+    }
+
+    const SnapshotNode &
+    Node(NodeIndex node) const
+    {
+        return nodes_[node];
+    }
+
+    std::string_view
+    Name(NodeIndex node) const
+    {
+        return {strings_ + nodes_[node].name_offset, nodes_[node].name_size};
+    }
+
+    bool
+    HasMetadata() const
+    {
+        return metadata_ != nullptr;
+    }
+
+    const NodeMetadata &
+    Metadata(NodeIndex node) const
+    {
+        return metadata_[node];
+    }
+
+private:
+    const char *data_ = nullptr;
+    size_t size_ = 0;
+    bool mapped_ = false;
+    std::vector<char> buffer_;
+
+    const SnapshotNode *nodes_ = nullptr;
+    const NodeMetadata *metadata_ = nullptr;
+    const char *strings_ = nullptr;
+    size_t node_count_ = 0;
+
+    void Validate();
+};
+
+} // namespace pyftpkit
+
+#endif
@@ -3,20 +3,48 @@
 # Copyright 2025 (c) Vladislav Punko <iam.vlad.punko@gmail.com>
 
 import asyncio
+import collections
 import ftplib
 import logging
+import time
 import typing
 import weakref
 from concurrent.futures import ThreadPoolExecutor
 
+from pyftpkit import metrics
+from pyftpkit._aioftp import AsyncFTP
 from pyftpkit._ftp import FTP
+from pyftpkit._routing import (
+    EndpointLoad,
+    candidates,
+    endpoint_loads,
+    expected_latency,
+)
 from pyftpkit.connection_parameters import ConnectionParameters
 from pyftpkit.exceptions import FTPError
 
-__all__ = ["FTPPoolExecutor"]
+__all__ = ["Connection", "FTPPoolExecutor"]
 
 logger = logging.getLogger("pyftpkit")
 
+Connection: typing.TypeAlias = FTP | AsyncFTP
+
+
+class _Endpoint(EndpointLoad):
+    """Connection slots of one server along with its load."""
+
+    __slots__ = ("stack",)
+
+    def __init__(self, host: str, port: int, limit: int) -> None:
+        super().__init__(host, port, limit)
+
+        # Free slots at the bottom and idle connections on top of them.
+        self.stack: list[Connection | None] = [None] * limit
+
+    def route_key(self, estimate: float) -> tuple[float, float, bool, bool]:
+        """Orders servers by load, preferring idle connections among equals."""
+        return (*self.key(estimate), self.stack[-1] is None)
+
 
 class FTPPoolExecutor:
     """Asynchronous FTP connection pool executor.
@@ -26,6 +54,18 @@ class FTPPoolExecutor:
     command-oriented and not inherently asynchronous, pooling allows the
     application to efficiently handle multiple concurrent FTP operations
     without blocking the event loop.
+
+    The pool opens min_connections sessions upfront and grows up to
+    max_connections on demand. Every slot without a session is a None entry
+    of the stack, so the most recently used sessions are handed out first and
+    a free slot is only taken once all of them are busy. Sessions idle for the
+    keep-alive interval receive a NOOP, and dead ones are replaced on demand.
+
+    Mirrors get stacks of their own, sized by their session limits. Every get
+    goes to the server with the least expected wait given the connections in
+    use and the round trips observed there, so the load spreads over all of
+    them. A server that cannot be connected to is backed off from for a while
+    and the get moves on to the next one.
     """
 
     def __init__(
@@ -37,12 +77,20 @@ class FTPPoolExecutor:
         self._connection_parameters = connection_parameters
 
         # We need to track all connections for proper cleanup.
-        self._connections: weakref.WeakSet[FTP] = weakref.WeakSet()
+        self._connections: weakref.WeakSet[Connection] = weakref.WeakSet()
+        self._owners: weakref.WeakKeyDictionary[Connection, _Endpoint] = (
+            weakref.WeakKeyDictionary()
+        )
+        self._endpoints: list[_Endpoint] = []
 
         # We need to ensure that all asynchronous objects are created during
         # pool initialization so they are bound to the correct event loop.
         self._lock: asyncio.Lock
-        self._pool: asyncio.Queue[FTP]
+        self._waiters: collections.deque[asyncio.Future[None]] = collections.deque()
+
+        # Event loop time at which each idle connection was put back.
+        self._idle_since: dict[Connection, float] = {}
+        self._keepalive: asyncio.Task[None] | None = None
 
         self._closed: bool = True
 
@@ -84,11 +132,23 @@ class FTPPoolExecutor:
                 "A new pool lock has been created and bound to the current event loop."
             )
 
-    def _connect(self) -> FTP:
+    def _address(self, endpoint: EndpointLoad | None) -> tuple[str, int]:
+        """Returns the host and port of a server, the main one by default."""
+        if endpoint is None:
+            return self._connection_parameters.host, self._connection_parameters.port
+
+        return endpoint.host, endpoint.port
+
+    def _connect(self, endpoint: EndpointLoad | None = None) -> FTP:
         """Opens a new FTP session using the provided connection parameters.
 
         Passive mode is enabled by default.
 
+        Parameters
+        ----------
+        endpoint : EndpointLoad, optional
+            Server to connect to instead of the main one.
+
         Returns
         -------
         FTP
@@ -99,46 +159,107 @@ class FTPPoolExecutor:
         FTPError
             If the connection or login fails due to network or authentication issues.
         """
+        host, port = self._address(endpoint)
         try:
             ftp = FTP()
-            ftp.connect(
-                self._connection_parameters.host,
-                self._connection_parameters.port,
-                timeout=self._connection_parameters.timeout,
-            )
+            ftp.connect(host, port, timeout=self._connection_parameters.timeout)
             ftp.login(
                 self._connection_parameters.credentials.username,
                 self._connection_parameters.credentials.password.get_secret_value(),
             )
             ftp.set_pasv(True)
-            logger.debug(
-                "FTP connection has been created: %s:%s",
-                self._connection_parameters.host,
-                self._connection_parameters.port,
-            )
+            metrics.increment("pool_connections_opened_total")
+            logger.debug("FTP connection has been created: %s:%s", host, port)
 
             return ftp
         except ftplib.all_errors as err:
             logger.exception("Unable to create a new connection.")
             raise FTPError(
-                "Could not open an FTP connection to: {0!s}:{1!s}".format(
-                    self._connection_parameters.host,
-                    self._connection_parameters.port,
-                )
+                f"Could not open an FTP connection to: {host!s}:{port!s}"
             ) from err
 
+    async def _connect_async(self, endpoint: EndpointLoad | None = None) -> AsyncFTP:
+        """Opens a new FTP session that runs on the event loop.
+
+        Parameters
+        ----------
+        endpoint : EndpointLoad, optional
+            Server to connect to instead of the main one.
+
+        Returns
+        -------
+        AsyncFTP
+            A ready-to-use FTP client with an active authenticated connection.
+
+        Raises
+        ------
+        FTPError
+            If the connection or login fails due to network or authentication issues.
+        """
+        host, port = self._address(endpoint)
+        ftp = AsyncFTP()
+        try:
+            await ftp.connect(host, port, timeout=self._connection_parameters.timeout)
+            await ftp.login(
+                self._connection_parameters.credentials.username,
+                self._connection_parameters.credentials.password.get_secret_value(),
+            )
+            metrics.increment("pool_connections_opened_total")
+            logger.debug("FTP connection has been created: %s:%s", host, port)
+
+            return ftp
+        except (*ftplib.all_errors, asyncio.TimeoutError) as err:
+            await ftp.close()
+
+            logger.exception("Unable to create a new connection.")
+            raise FTPError(
+                f"Could not open an FTP connection to: {host!s}:{port!s}"
+            ) from err
+
+    async def _open_connection(self, endpoint: _Endpoint) -> Connection:
+        """Opens one tracked connection to a server with the configured backend."""
+        ftp: Connection
+        if self._connection_parameters.backend == "asyncio":
+            ftp = await self._connect_async(endpoint)
+        else:
+            loop = asyncio.get_running_loop()
+            ftp = await loop.run_in_executor(self._executor, self._connect, endpoint)
+
+        self._connections.add(ftp)
+        self._owners[ftp] = endpoint
+        endpoint.recover()
+
+        return ftp
+
     async def _open_connections(self) -> None:
-        """Creates and populates an FTP connection pool with active connections."""
+        """Creates the pool with the minimum number of active connections."""
         loop = asyncio.get_running_loop()
 
-        tasks = [
-            loop.run_in_executor(self._executor, self._connect)
-            for _ in range(self._connection_parameters.max_connections)
+        self._endpoints = [
+            _Endpoint(load.host, load.port, load.limit)
+            for load in endpoint_loads(self._connection_parameters)
         ]
+
+        # Upfront connections are spread over the servers in turn.
+        targets = [
+            endpoint
+            for level in range(max(endpoint.limit for endpoint in self._endpoints))
+            for endpoint in self._endpoints
+            if level < endpoint.limit
+        ][: self._connection_parameters.min_connections]
+
+        tasks: list[typing.Awaitable[Connection]]
+        if self._connection_parameters.backend == "asyncio":
+            tasks = [self._connect_async(endpoint) for endpoint in targets]
+        else:
+            tasks = [
+                loop.run_in_executor(self._executor, self._connect, endpoint)
+                for endpoint in targets
+            ]
         try:
             # Wait for all connections to be established.
-            connections: list[FTP] = await asyncio.wait_for(
-                asyncio.gather(*tasks, return_exceptions=False),
+            results: list[Connection | BaseException] = await asyncio.wait_for(
+                asyncio.gather(*tasks, return_exceptions=True),
                 timeout=self._connection_parameters.timeout,
             )
         except asyncio.TimeoutError as err:
@@ -147,17 +268,151 @@ class FTPPoolExecutor:
             )
             raise FTPError("FTP connection pool initialization timed out.") from err
 
-        for connection in connections:
+        opened: list[tuple[_Endpoint, Connection]] = []
+        errors: list[BaseException] = []
+        for endpoint, result in zip(targets, results):
+            if isinstance(result, BaseException):
+                endpoint.fail()
+                errors.append(result)
+            else:
+                opened.append((endpoint, result))
+
+        # Servers that cannot be reached are backed off from, and the pool only
+        # fails to open when none of them can.
+        if errors and not opened:
+            raise errors[0]
+
+        for endpoint, connection in opened:
             self._connections.add(connection)
-            await self._pool.put(connection)
+            self._owners[connection] = endpoint
+            self._idle_since[connection] = loop.time()
+
+            # Free slots lie below the open connections, so they are taken last.
+            endpoint.stack.remove(None)
+            endpoint.stack.append(connection)
 
         logger.debug(
             "FTP connection pool has been initialized with %d connections.",
-            self._connection_parameters.max_connections,
+            len(opened),
         )
 
+        if self._connection_parameters.keepalive_interval:
+            self._keepalive = asyncio.create_task(self._keep_alive())
+
         self._closed = False
 
+    async def _ping(self, ftp: Connection) -> bool:
+        """Sends a NOOP to check that the server still holds the session."""
+        try:
+            if isinstance(ftp, AsyncFTP):
+                await ftp.voidcmd("NOOP")
+            else:
+                loop = asyncio.get_running_loop()
+                await loop.run_in_executor(self._executor, ftp.voidcmd, "NOOP")
+        except (*ftplib.all_errors, asyncio.TimeoutError):
+            return False
+
+        return True
+
+    async def _evict(self, ftp: Connection) -> None:
+        """Drops a dead connection, its slot is refilled by the next get."""
+        self._connections.discard(ftp)
+        self._owners.pop(ftp, None)
+        self._idle_since.pop(ftp, None)
+
+        metrics.increment("pool_connections_evicted_total")
+        logger.warning("A dead FTP connection has been evicted from the pool.")
+
+        # The session is gone already, so there is no point in sending QUIT.
+        if isinstance(ftp, AsyncFTP):
+            await ftp.close()
+        else:
+            try:
+                ftp.close()
+            except ftplib.all_errors:
+                pass
+
+    async def _keep_alive(self) -> None:
+        """Sends NOOP over connections idle for the whole keep-alive interval.
+
+        Servers drop sessions that stay quiet for too long, which would
+        otherwise surface as a failing command of the next operation.
+        """
+        interval = self._connection_parameters.keepalive_interval
+        loop = asyncio.get_running_loop()
+
+        while True:
+            await asyncio.sleep(interval)
+
+            now = loop.time()
+
+            stale: list[tuple[_Endpoint, Connection]] = []
+            for endpoint in self._endpoints:
+                stack: list[Connection | None] = []
+                for item in endpoint.stack:
+                    if item is not None and now - self._idle_since[item] >= interval:
+                        stale.append((endpoint, item))
+                    else:
+                        stack.append(item)
+                endpoint.stack = stack
+
+            alive = await asyncio.gather(*(self._ping(ftp) for _, ftp in stale))
+            for (endpoint, ftp), is_alive in zip(stale, alive):
+                if is_alive:
+                    self._idle_since[ftp] = loop.time()
+                    self._put(endpoint, ftp)
+                else:
+                    await self._evict(ftp)
+                    self._put(endpoint, None)
+
+    def _put(self, endpoint: _Endpoint, item: Connection | None) -> None:
+        """Pushes a connection or a free slot and wakes up one waiting get.
+
+        Free slots go to the bottom of the stack, so idle connections are
+        always handed out before a new one is opened.
+        """
+        if item is None:
+            endpoint.stack.insert(0, item)
+        else:
+            endpoint.stack.append(item)
+        self._wake()
+
+    def _wake(self) -> None:
+        """Wakes up the longest waiting get that is still waiting."""
+        while self._waiters:
+            waiter = self._waiters.popleft()
+            if not waiter.done():
+                waiter.set_result(None)
+                break
+
+    async def _acquire(self) -> _Endpoint:
+        """Waits for the least loaded server with an idle connection or slot."""
+        loop = asyncio.get_running_loop()
+
+        while True:
+            # Servers backing off are left alone while others can take the load.
+            available = [
+                endpoint for endpoint in candidates(self._endpoints) if endpoint.stack
+            ]
+            if available:
+                estimate = expected_latency(self._endpoints)
+
+                return min(available, key=lambda item: item.route_key(estimate))
+
+            waiter: asyncio.Future[None] = loop.create_future()
+            self._waiters.append(waiter)
+            try:
+                await waiter
+            except asyncio.CancelledError:
+                # Pass a wake-up that arrived together with the cancellation on.
+                if not waiter.cancelled():
+                    self._wake()
+                raise
+
+    def qsize(self) -> int:
+        """Returns the number of idle connections and free slots."""
+        return sum(len(endpoint.stack) for endpoint in self._endpoints)
+
     async def open(self) -> None:
         """Initializes the FTP connection pool.
 
@@ -175,54 +430,125 @@ class FTPPoolExecutor:
         self._ensure_lock()
 
         async with self._lock:
-            self._pool = asyncio.Queue(
-                maxsize=self._connection_parameters.max_connections
-            )
-
             await self._open_connections()
 
-    async def get(self) -> FTP:
+    async def get(self) -> Connection:
         """Acquires an FTP connection from the pool.
 
+        Opens a new connection when every open one is busy and the pool has not
+        reached its maximum size yet. Connections idle for the keep-alive
+        interval are checked with NOOP first and replaced if they are dead.
+        Should a server refuse the new connection, the next one is tried until
+        every server is backing off.
+
         Returns
         -------
-        FTP
+        FTP or AsyncFTP
             An active FTP connection from the pool.
 
         Raises
         ------
         RuntimeError
             If the connection pool has not been initialized.
+
+        FTPError
+            If a new connection cannot be opened.
         """
-        if self._closed or getattr(self, "_pool", None) is None:
+        if self._closed or not self._endpoints:
             logger.error(
                 "There is no active connection pool to acquire an FTP connection from."
             )
             raise RuntimeError("Connection pool is not initialized or is closed.")
 
-        return await self._pool.get()
+        started = time.perf_counter()
+
+        while True:
+            endpoint = await self._acquire()
+            ftp = endpoint.stack.pop()
+            endpoint.in_flight += 1
+            try:
+                if ftp is not None and not await self._check(ftp):
+                    await self._evict(ftp)
+                    ftp = None
+
+                if ftp is None:
+                    ftp = await self._open_connection(endpoint)
+            except BaseException as err:
+                # The slot stays free for the next caller to try again.
+                endpoint.in_flight -= 1
+                self._put(endpoint, None)
+
+                if not isinstance(err, FTPError):
+                    raise
+
+                endpoint.fail()
+                now = time.monotonic()
+                if all(item.retry_at > now for item in self._endpoints):
+                    raise  # every server is backing off
+
+                logger.warning(
+                    "Moving on from an unreachable FTP server: %s:%s",
+                    endpoint.host,
+                    endpoint.port,
+                )
+                continue
+
+            break
+
+        metrics.observe("pool_wait_seconds", time.perf_counter() - started)
+        metrics.increment("pool_acquired_total")
+
+        return ftp
+
+    async def _check(self, ftp: Connection) -> bool:
+        """Checks an idle connection before it is handed out."""
+        loop = asyncio.get_running_loop()
+        idle = loop.time() - self._idle_since.pop(ftp, loop.time())
+
+        if ftp.closed:
+            return False
 
-    async def release(self, ftp: FTP) -> None:
+        interval = self._connection_parameters.keepalive_interval
+        if interval and idle >= interval:
+            return await self._ping(ftp)
+
+        return True
+
+    async def release(self, ftp: Connection) -> None:
         """Returns an FTP connection back to the pool for reuse.
 
         Parameters
         ----------
-        ftp : FTP
+        ftp : FTP or AsyncFTP
             The FTP connection to be returned to the pool.
         """
-        if self._closed or getattr(self, "_pool", None) is None:
+        if self._closed or not self._endpoints:
             logger.error(
                 "No active connection pool available to release the FTP connection."
             )
             raise RuntimeError("FTP connection pool does not exist or is closed.")
 
         # Ensure the connection is still in the weak set before putting it back.
-        if ftp not in self._connections:
+        endpoint = self._owners.get(ftp)
+        if ftp not in self._connections or endpoint is None:
             logger.warning("Released FTP connection was not tracked.")
 
             return None
 
-        await self._pool.put(ftp)
+        endpoint.in_flight -= 1
+
+        # Connections closed by a failed command free their slot right away.
+        if ftp.closed:
+            await self._evict(ftp)
+            self._put(endpoint, None)
+
+            return None
+
+        if ftp.rtt is not None:
+            endpoint.observe(ftp.rtt)
+
+        self._idle_since[ftp] = asyncio.get_running_loop().time()
+        self._put(endpoint, ftp)
 
     def _close_connection(self, ftp: FTP) -> None:
         """Safely closes a single FTP connection."""
@@ -240,29 +566,49 @@ class FTPPoolExecutor:
                     )
                 ) from err
 
+    async def _close_async_connection(self, ftp: AsyncFTP) -> None:
+        """Safely closes a single FTP connection running on the event loop."""
+        try:
+            await ftp.quit()
+        except (*ftplib.all_errors, asyncio.TimeoutError):
+            await ftp.close()
+
     async def close(self) -> None:
         """Safely closes all FTP connections in the pool."""
-        if getattr(self, "_pool", None) is None:
+        if not self._endpoints:
             logger.debug("No pool to close.")
 
             return None
 
-        connections: set[FTP] = set()
+        connections: set[Connection] = set()
         async with self._lock:
             if self._closed:
                 return None
 
             loop = asyncio.get_running_loop()
 
-            while not self._pool.empty():  # drain the pool queue
-                connections.add(await self._pool.get())
+            if self._keepalive is not None:
+                self._keepalive.cancel()
+                await asyncio.gather(self._keepalive, return_exceptions=True)
+                self._keepalive = None
+
+            for endpoint in self._endpoints:  # drain the pool stacks
+                connections.update(item for item in endpoint.stack if item is not None)
+                endpoint.stack.clear()
             connections.update(self._connections)
 
             # Clear the weakset now that we have a strong reference to all connections.
             self._connections.clear()
+            self._idle_since.clear()
 
             tasks = [
-                loop.run_in_executor(self._executor, self._close_connection, connection)
+                (
+                    self._close_async_connection(connection)
+                    if isinstance(connection, AsyncFTP)
+                    else loop.run_in_executor(
+                        self._executor, self._close_connection, connection
+                    )
+                )
                 for connection in connections
             ]
             await asyncio.gather(*tasks)
@@ -2,15 +2,24 @@
 
 # Copyright 2025 (c) Vladislav Punko <iam.vlad.punko@gmail.com>
 
+import collections
 import io
 import logging
 import os
 import pathlib
+import threading
 import typing
 import urllib.parse
 
 import pycurl
 
+from pyftpkit import metrics
+from pyftpkit._routing import (
+    EndpointLoad,
+    candidates,
+    endpoint_loads,
+    expected_latency,
+)
 from pyftpkit.connection_parameters import ConnectionParameters
 from pyftpkit.exceptions import FTPError
 
@@ -18,14 +27,276 @@ __all__ = ["PycURL"]
 
 logger = logging.getLogger("pyftpkit")
 
+# Smallest range worth a connection of its own in segmented downloads.
+_MIN_SEGMENT_SIZE: typing.Final[int] = 16_777_216  # 16 MB
+
+# Error codes telling that a server could not be reached or logged in to.
+_UNREACHABLE: typing.Final[frozenset[int]] = frozenset(
+    code
+    for name in (
+        "E_COULDNT_RESOLVE_HOST",
+        "E_COULDNT_CONNECT",
+        "E_OPERATION_TIMEDOUT",
+        "E_FTP_WEIRD_SERVER_REPLY",
+        "E_FTP_ACCEPT_TIMEOUT",
+        "E_LOGIN_DENIED",
+        "E_GOT_NOTHING",
+        "E_SEND_ERROR",
+        "E_RECV_ERROR",
+    )
+    if (code := getattr(pycurl, name, None)) is not None
+)
+
+
+def _record_transfer(curl: pycurl.Curl, upload: bool) -> None:
+    """Reports the size, the rate and the new connections of a finished transfer."""
+    if not metrics.enabled():
+        return None
+
+    direction = "upload" if upload else "download"
+
+    size = curl.getinfo(pycurl.SIZE_UPLOAD if upload else pycurl.SIZE_DOWNLOAD)
+    seconds = curl.getinfo(pycurl.TOTAL_TIME)
+
+    metrics.increment("transfer_bytes_total", size, direction=direction)
+    if seconds > 0:
+        metrics.observe(
+            "transfer_bytes_per_second", size / seconds, direction=direction
+        )
+
+    # Transfers over a cached connection do not open any.
+    metrics.increment(
+        "transfer_connects_total",
+        curl.getinfo(pycurl.NUM_CONNECTS),
+        direction=direction,
+    )
+
+
+class _FileSink:
+    """Writes received data straight to a file descriptor.
+
+    Every chunk handed over by cURL goes to the descriptor in a single system
+    call without another copy into a Python file buffer. With preallocation the
+    remote size announced by the server is reserved on the first chunk, which
+    keeps large files contiguous on disk; the file is cut back to the received
+    size on close in case the transfer ends early.
+    """
+
+    def __init__(
+        self, path: str | pathlib.Path, curl: pycurl.Curl, preallocate: bool
+    ) -> None:
+        flags = os.O_WRONLY | os.O_CREAT | os.O_TRUNC | getattr(os, "O_BINARY", 0)
+        self._fd = os.open(path, flags, 0o666)
+        self._curl = curl
+        self._preallocate = preallocate and hasattr(os, "posix_fallocate")
+        self._reserved: int = 0
+        self._size: int = 0
+
+        # Errors cannot propagate through cURL, so they are kept for the caller.
+        self.error: OSError | None = None
+
+    def write(self, data: bytes) -> int:
+        """Writes a chunk and returns its size, or zero to abort the transfer."""
+        try:
+            if self._preallocate:
+                self._preallocate = False
+                self._reserve()
+
+            view = memoryview(data)
+            while view:
+                view = view[os.write(self._fd, view) :]
+        except OSError as err:
+            self.error = err
+            return 0
+
+        self._size += len(data)
+        return len(data)
+
+    def _reserve(self) -> None:
+        """Reserves disk space for the announced size of the remote file."""
+        size = int(self._curl.getinfo(pycurl.CONTENT_LENGTH_DOWNLOAD))
+        if size <= 0:
+            return None
+
+        try:
+            os.posix_fallocate(self._fd, 0, size)
+        except OSError:
+            return None  # not every file system supports preallocation
+
+        self._reserved = size
+
+    def close(self) -> None:
+        """Closes the file descriptor, dropping any unused reserved space."""
+        if self._fd < 0:
+            return None
+
+        fd, self._fd = self._fd, -1
+        try:
+            if self._reserved > self._size:
+                os.ftruncate(fd, self._size)
+        finally:
+            os.close(fd)
+
+    def __enter__(self) -> "_FileSink":
+        return self
+
+    def __exit__(self, *args: typing.Any) -> None:
+        self.close()
+
+
+class _RangeSink:
+    """Writes one byte range of a segmented download at its own offset."""
+
+    def __init__(self, fd: int, offset: int, length: int) -> None:
+        self._fd = fd
+        self._offset = offset
+        self._length = length
+        self.size: int = 0
+
+        # Errors cannot propagate through cURL, so they are kept for the caller.
+        self.error: OSError | None = None
+
+    def write(self, data: bytes) -> int:
+        """Writes a chunk at the current position and returns its size."""
+        # Servers may keep sending past the range before the transfer is aborted.
+        view = memoryview(data)[: self._length - self.size]
+        try:
+            while view:
+                written = os.pwrite(self._fd, view, self._offset + self.size)
+                self.size += written
+                view = view[written:]
+        except OSError as err:
+            self.error = err
+            return 0
+
+        return len(data)
+
+
+class _Readable(typing.Protocol):
+    """Source of the data of a streamed upload."""
+
+    def read(self, size: int) -> bytes: ...
+
+
+class _Transfer(typing.NamedTuple):
+    """Transfer attached to an easy handle of the multi interface."""
+
+    src: str | pathlib.Path
+    dst: str | pathlib.Path
+    url: str
+    stream: _FileSink | typing.IO[bytes]
+    endpoint: EndpointLoad
+
 
 class PycURL:
-    """A lightweight cURL wrapper for efficient FTP file transfers."""
+    """A lightweight cURL wrapper for efficient FTP file transfers.
+
+    Easy handles are kept per thread and reset between transfers, which keeps
+    their connections alive, so consecutive files skip the connect and login
+    round trips. Batches go through the multi interface to run many transfers
+    from a single thread; every thread keeps its multi handle and the easy
+    handles of its batches as well, so later batches find the connections of
+    the earlier ones.
+
+    With mirrors configured, every transfer goes to the server with the least
+    expected wait given its transfers in flight, its session limit and the time
+    to the first byte observed there. Paths given as full URLs are never routed.
+    """
 
     def __init__(self, connection_parameters: ConnectionParameters) -> None:
         self._connection_parameters = connection_parameters
 
-    def _ensure_ftp_url(self, path: str | pathlib.Path) -> str:
+        self._local = threading.local()
+        self._lock = threading.Lock()
+        self._handles: list[pycurl.Curl] = []
+        self._multis: list[pycurl.CurlMulti] = []
+
+        self._endpoints = endpoint_loads(connection_parameters)
+
+    def _handle(self) -> pycurl.Curl:
+        """Returns the easy handle of the calling thread, reset to the defaults."""
+        curl = getattr(self._local, "curl", None)
+        if curl is None:
+            curl = self._local.curl = pycurl.Curl()
+            with self._lock:
+                self._handles.append(curl)
+        else:
+            # Resetting keeps the live connections and the DNS cache of the handle.
+            curl.reset()
+
+        return curl
+
+    def _batch(self, count: int) -> tuple[pycurl.CurlMulti, list[pycurl.Curl]]:
+        """Returns the multi handle of the calling thread and its easy handles.
+
+        The thread keeps at least the given number of easy handles for batches,
+        more are created as larger batches come. None of them is attached to the
+        multi handle in between batches.
+        """
+        multi = getattr(self._local, "multi", None)
+        if multi is None:
+            multi = self._local.multi = pycurl.CurlMulti()
+            self._local.batch = []
+            with self._lock:
+                self._multis.append(multi)
+
+        handles: list[pycurl.Curl] = self._local.batch
+        while len(handles) < count:
+            curl = pycurl.Curl()
+            handles.append(curl)
+            with self._lock:
+                self._handles.append(curl)
+
+        return multi, handles[:count]
+
+    def close(self) -> None:
+        """Closes every handle along with its connections."""
+        with self._lock:
+            handles, self._handles = self._handles, []
+            multis, self._multis = self._multis, []
+        for curl in handles:
+            curl.close()
+        for multi in multis:
+            multi.close()
+
+        self._local = threading.local()
+
+    def _route(self) -> EndpointLoad:
+        """Picks the server for the next transfer and counts it as in flight.
+
+        Servers backing off from failures to reach them are skipped while any
+        other one is available.
+        """
+        with self._lock:
+            estimate = expected_latency(self._endpoints)
+            endpoint = min(
+                candidates(self._endpoints), key=lambda item: item.key(estimate)
+            )
+            endpoint.in_flight += 1
+
+        return endpoint
+
+    def _unroute(
+        self,
+        endpoint: EndpointLoad,
+        curl: pycurl.Curl | None,
+        errno: int | None = None,
+    ) -> None:
+        """Ends a transfer on a server, learning its latency if it succeeded.
+
+        A transfer that failed to reach the server backs the server off, so
+        the following transfers and retries go to the next one.
+        """
+        with self._lock:
+            endpoint.in_flight -= 1
+            if curl is not None:
+                endpoint.observe(float(curl.getinfo(pycurl.STARTTRANSFER_TIME)))
+            elif errno in _UNREACHABLE:
+                endpoint.fail()
+
+    def _ensure_ftp_url(
+        self, path: str | pathlib.Path, endpoint: EndpointLoad | None = None
+    ) -> str:
         """Ensures a proper FTP URL for the given path using the connection parameters.
 
         Parameters
@@ -33,6 +304,9 @@ class PycURL:
         path : str or pathlib.Path
             The FTP path to normalize and convert into a URL.
 
+        endpoint : EndpointLoad, optional
+            Server to address instead of the main one.
+
         Returns
         -------
         str
@@ -46,38 +320,20 @@ class PycURL:
         # Ensure the path is consistently formatted and safely encoded for URL usage.
         normpath = urllib.parse.quote(path.strip().lstrip("/") or "/", safe="/")
 
-        host = self._connection_parameters.host
-        port = self._connection_parameters.port
+        host = self._connection_parameters.host if endpoint is None else endpoint.host
+        port = self._connection_parameters.port if endpoint is None else endpoint.port
         netloc = f"{host!s}:{port!s}" if port and port > 0 else host
 
         return urllib.parse.urlunparse(("ftp", netloc, normpath, "", "", ""))
 
-    def download(self, src: str | pathlib.Path, dst: str | pathlib.Path) -> float:
-        """Fetches a remote file and writes it to the local filesystem.
-
-        Adds the FTP protocol prefix to the source path if missing.
-
-        Parameters
-        ----------
-        src : str or pathlib.Path
-            The FTP path to the remote file to be downloaded.
-
-        dst : str or pathlib.Path
-            The local filesystem path where the file will be saved.
-
-        Returns
-        -------
-        float
-            The total number of bytes successfully downloaded.
-
-        Raises
-        ------
-        RuntimeError
-            If the destination directory cannot be created or written to.
-
-        FTPError
-            If any network or FTP-related issue occurs during download.
-        """
+    def _prepare_download(
+        self,
+        curl: pycurl.Curl,
+        src: str | pathlib.Path,
+        dst: str | pathlib.Path,
+        endpoint: EndpointLoad | None = None,
+    ) -> str:
+        """Creates the target directory and configures a handle for a download."""
         if dirname := os.path.dirname(os.path.expanduser(dst)):
             try:
                 os.makedirs(dirname, exist_ok=True)
@@ -89,14 +345,18 @@ class PycURL:
                     f"Could not create target directory: {dirname!s}"
                 ) from err
 
-        src = self._ensure_ftp_url(src)
+        src = self._ensure_ftp_url(src, endpoint)
         logger.debug(
             "Downloading '%s' from FTP server to '%s' on the local machine.", src, dst
         )
+        self._configure_download(curl, src)
 
-        curl = pycurl.Curl()
+        return src
+
+    def _configure_download(self, curl: pycurl.Curl, url: str) -> None:
+        """Sets the options shared by every kind of download on a handle."""
         curl.setopt(pycurl.CONNECTTIMEOUT, self._connection_parameters.timeout)
-        curl.setopt(pycurl.URL, src)
+        curl.setopt(pycurl.URL, url)
         curl.setopt(
             pycurl.USERPWD,
             "{0!s}:{1!s}".format(
@@ -107,13 +367,79 @@ class PycURL:
         curl.setopt(pycurl.FTP_FILEMETHOD, pycurl.FTPMETHOD_NOCWD)
         curl.setopt(pycurl.FTP_USE_EPSV, 1)
         curl.setopt(pycurl.NOSIGNAL, 1)  # essential for multi-threaded programs
-        curl.setopt(pycurl.BUFFERSIZE, io.DEFAULT_BUFFER_SIZE)
+        curl.setopt(pycurl.BUFFERSIZE, self._connection_parameters.buffer_size)
+        for option, value in self._connection_parameters.extra_options.items():
+            curl.setopt(option, value)
+
+    def _prepare_upload(
+        self,
+        curl: pycurl.Curl,
+        src: str | pathlib.Path,
+        dst: str | pathlib.Path,
+        endpoint: EndpointLoad | None = None,
+        size: int | None = None,
+    ) -> str:
+        """Configures a handle for an upload of a known size, the source by default."""
+        dst = self._ensure_ftp_url(dst, endpoint)
+        logger.debug("Starting file upload from local '%s' to FTP path '%s'.", src, dst)
+
+        curl.setopt(pycurl.CONNECTTIMEOUT, self._connection_parameters.timeout)
+        curl.setopt(pycurl.URL, dst)
+        curl.setopt(
+            pycurl.USERPWD,
+            "{0!s}:{1!s}".format(
+                self._connection_parameters.credentials.username,
+                self._connection_parameters.credentials.password.get_secret_value(),
+            ),
+        )
+        curl.setopt(pycurl.FTP_USE_EPSV, 1)
+        curl.setopt(pycurl.NOSIGNAL, 1)  # crucial for programs with multiple threads
+        curl.setopt(pycurl.FTP_CREATE_MISSING_DIRS, 1)
+        curl.setopt(pycurl.INFILESIZE, os.path.getsize(src) if size is None else size)
+        curl.setopt(pycurl.UPLOAD, 1)
         for option, value in self._connection_parameters.extra_options.items():
             curl.setopt(option, value)
+
+        return dst
+
+    def download(self, src: str | pathlib.Path, dst: str | pathlib.Path) -> float:
+        """Fetches a remote file and writes it to the local filesystem.
+
+        Adds the FTP protocol prefix to the source path if missing.
+
+        Parameters
+        ----------
+        src : str or pathlib.Path
+            The FTP path to the remote file to be downloaded.
+
+        dst : str or pathlib.Path
+            The local filesystem path where the file will be saved.
+
+        Returns
+        -------
+        float
+            The total number of bytes successfully downloaded.
+
+        Raises
+        ------
+        RuntimeError
+            If the destination directory cannot be created or written to.
+
+        FTPError
+            If any network or FTP-related issue occurs during download.
+        """
+        curl = self._handle()
+        endpoint = self._route()
+        succeeded = False
+        errno: int | None = None
+        sink: _FileSink | None = None
         try:
-            with io.open(dst, mode="wb") as buffer:
-                curl.setopt(pycurl.WRITEDATA, buffer)
+            src = self._prepare_download(curl, src, dst, endpoint)
+            with _FileSink(dst, curl, self._connection_parameters.preallocate) as sink:
+                curl.setopt(pycurl.WRITEFUNCTION, sink.write)
                 curl.perform()
+                _record_transfer(curl, False)
+                succeeded = True
 
                 size_bytes = typing.cast(
                     float, curl.getinfo(pycurl.SIZE_DOWNLOAD)  # type: ignore
@@ -127,6 +453,14 @@ class PycURL:
 
                 return size_bytes
         except pycurl.error as err:
+            errno = err.args[0]
+            if sink is not None and sink.error is not None:
+                logger.error(
+                    "An error occurred while trying to write the buffer to disk."
+                )
+                message = f"Failed to write buffer data to: {dst!s}"
+                raise RuntimeError(message) from sink.error
+
             logger.exception("An unexpected error occurred while fetching the data.")
             raise FTPError(
                 f"Encountered an error while trying to fetch the data from: {src!s}"
@@ -139,7 +473,7 @@ class PycURL:
             raise RuntimeError(f"Failed to write buffer data to: {dst!s}") from err
 
         finally:
-            curl.close()
+            self._unroute(endpoint, curl if succeeded else None, errno)
 
     def upload(self, src: str | pathlib.Path, dst: str | pathlib.Path) -> None:
         """Uploads a local file to the remote FTP server.
@@ -164,32 +498,20 @@ class PycURL:
         FTPError
             If the FTP upload fails due to network or server-side issues.
         """
-        dst = self._ensure_ftp_url(dst)
-        logger.debug("Starting file upload from local '%s' to FTP path '%s'.", src, dst)
-
-        curl = pycurl.Curl()
-        curl.setopt(pycurl.CONNECTTIMEOUT, self._connection_parameters.timeout)
-        curl.setopt(pycurl.URL, dst)
-        curl.setopt(
-            pycurl.USERPWD,
-            "{0!s}:{1!s}".format(
-                self._connection_parameters.credentials.username,
-                self._connection_parameters.credentials.password.get_secret_value(),
-            ),
-        )
-        curl.setopt(pycurl.FTP_USE_EPSV, 1)
-        curl.setopt(pycurl.NOSIGNAL, 1)  # crucial for programs with multiple threads
-        curl.setopt(pycurl.FTP_CREATE_MISSING_DIRS, 1)
-        curl.setopt(pycurl.INFILESIZE, os.path.getsize(src))
-        curl.setopt(pycurl.UPLOAD, 1)
-        for option, value in self._connection_parameters.extra_options.items():
-            curl.setopt(option, value)
+        curl = self._handle()
+        endpoint = self._route()
+        succeeded = False
+        errno: int | None = None
         try:
+            dst = self._prepare_upload(curl, src, dst, endpoint)
             with io.open(src, mode="rb") as stream:
                 curl.setopt(pycurl.READDATA, stream)
                 curl.perform()
+                _record_transfer(curl, True)
+                succeeded = True
                 logger.debug("Completed FTP upload of '%s' to '%s'.", src, dst)
         except pycurl.error as err:
+            errno = err.args[0]
             logger.exception("File could not be uploaded to the FTP server.")
             raise FTPError(
                 f"Could not upload {str(src)!r} to {dst!r} on FTP server."
@@ -202,4 +524,641 @@ class PycURL:
             ) from err
 
         finally:
-            curl.close()
+            self._unroute(endpoint, curl if succeeded else None, errno)
+
+    def upload_stream(
+        self, stream: _Readable, dst: str | pathlib.Path, size: int
+    ) -> None:
+        """Uploads the data read from a stream to the remote FTP server.
+
+        The stream is read in chunks as the transfer progresses, so the data can
+        be produced on the fly. Missing directories are created on the way.
+
+        Parameters
+        ----------
+        stream : object with a read method
+            Source of the data, read until it returns an empty result.
+
+        dst : str or pathlib.Path
+            Path on the FTP server where the data should be placed.
+
+        size : int
+            Exact number of bytes the stream is going to produce.
+
+        Raises
+        ------
+        RuntimeError
+            If reading the stream fails.
+
+        FTPError
+            If the FTP upload fails due to network or server-side issues.
+        """
+        # Errors cannot propagate through cURL, so they are kept for the caller.
+        errors: list[OSError] = []
+
+        def read(length: int) -> bytes | int:
+            try:
+                return stream.read(length)
+            except OSError as err:
+                errors.append(err)
+                return pycurl.READFUNC_ABORT
+
+        curl = self._handle()
+        endpoint = self._route()
+        succeeded = False
+        errno: int | None = None
+        try:
+            dst = self._prepare_upload(curl, str(stream), dst, endpoint, size)
+            curl.setopt(pycurl.READFUNCTION, read)
+            curl.perform()
+            _record_transfer(curl, True)
+            succeeded = True
+            logger.debug("Completed FTP upload of '%s' to '%s'.", stream, dst)
+        except pycurl.error as err:
+            errno = err.args[0]
+            if errors:
+                logger.error("An error occurred while reading the upload stream.")
+                raise RuntimeError(
+                    f"An error occurred while reading the stream: {stream!s}."
+                ) from errors[0]
+
+            logger.exception("File could not be uploaded to the FTP server.")
+            raise FTPError(
+                f"Could not upload {str(stream)!r} to {dst!r} on FTP server."
+            ) from err
+
+        finally:
+            self._unroute(endpoint, curl if succeeded else None, errno)
+
+    def _start_download(
+        self, curl: pycurl.Curl, src: str | pathlib.Path, dst: str | pathlib.Path
+    ) -> _Transfer:
+        """Configures a handle of the multi interface for a download."""
+        endpoint = self._route()
+        try:
+            url = self._prepare_download(curl, src, dst, endpoint)
+            sink = _FileSink(dst, curl, self._connection_parameters.preallocate)
+        except (IOError, OSError) as err:
+            self._unroute(endpoint, None)
+
+            logger.exception(
+                "An error occurred while trying to write the buffer to disk."
+            )
+            raise RuntimeError(f"Failed to write buffer data to: {dst!s}") from err
+
+        except BaseException:
+            self._unroute(endpoint, None)
+            raise
+
+        curl.setopt(pycurl.WRITEFUNCTION, sink.write)
+
+        return _Transfer(src, dst, url, sink, endpoint)
+
+    def _start_upload(
+        self, curl: pycurl.Curl, src: str | pathlib.Path, dst: str | pathlib.Path
+    ) -> _Transfer:
+        """Configures a handle of the multi interface for an upload."""
+        endpoint = self._route()
+        try:
+            url = self._prepare_upload(curl, src, dst, endpoint)
+            stream = io.open(src, mode="rb")
+        except (IOError, OSError) as err:
+            self._unroute(endpoint, None)
+
+            logger.exception("File read operation failed on local system.")
+            raise RuntimeError(
+                f"An error occurred while accessing the local file: {src!s}."
+            ) from err
+
+        except BaseException:
+            self._unroute(endpoint, None)
+            raise
+
+        curl.setopt(pycurl.READDATA, stream)
+
+        return _Transfer(src, dst, url, stream, endpoint)
+
+    def _perform_many(
+        self,
+        pairs: typing.Iterable[tuple[str | pathlib.Path, str | pathlib.Path]],
+        upload: bool,
+        concurrency: int | None,
+        progress: typing.Callable[[], typing.Any] | None,
+    ) -> float:
+        """Drives a window of transfers through the multi handle of the thread.
+
+        The multi handle owns a connection cache shared by its easy handles, and
+        every handle picks up the next pair once its transfer is done. Both are
+        kept for the next batch, so only the first transfers of the thread pay
+        for connecting and logging in.
+
+        A failed transfer is repeated right away on the next free handle for as
+        many retries as configured. Transfers that still fail do not stop the
+        rest of the batch; the first of them is raised once the batch is done.
+        Failures to write to the local disk are raised at once.
+        """
+        start = self._start_upload if upload else self._start_download
+        info = pycurl.SIZE_UPLOAD if upload else pycurl.SIZE_DOWNLOAD
+
+        if concurrency is None:
+            concurrency = self._connection_parameters.max_workers
+
+        retries = self._connection_parameters.retries
+
+        pairs = iter(pairs)
+        multi, idle = self._batch(max(1, concurrency))
+        active: dict[pycurl.Curl, tuple[_Transfer, int]] = {}
+        repeats: collections.deque[tuple[tuple[typing.Any, typing.Any], int]] = (
+            collections.deque()
+        )
+        failures: list[Exception] = []
+        size_bytes: float = 0.0
+        try:
+            while True:
+                while idle:
+                    if repeats:
+                        pair, attempt = repeats.popleft()
+                    elif (pair := next(pairs, None)) is not None:
+                        attempt = 0
+                    else:
+                        break
+
+                    curl = idle.pop()
+                    curl.reset()
+                    active[curl] = (start(curl, *pair), attempt)
+                    multi.add_handle(curl)
+
+                if not active:
+                    break
+
+                while True:
+                    ret, _ = multi.perform()
+                    if ret != pycurl.E_CALL_MULTI_PERFORM:
+                        break
+
+                finished: bool = False
+                while True:
+                    queued, succeeded, failed = multi.info_read()
+
+                    for curl in succeeded:
+                        transfer, _ = active.pop(curl)
+                        multi.remove_handle(curl)
+                        transfer.stream.close()
+                        self._unroute(transfer.endpoint, curl)
+                        idle.append(curl)
+                        finished = True
+
+                        size_bytes += typing.cast(float, curl.getinfo(info))
+                        _record_transfer(curl, upload)
+                        logger.debug(
+                            "Completed transfer from '%s' to '%s'.",
+                            transfer.src,
+                            transfer.dst,
+                        )
+                        if progress is not None:
+                            progress()
+
+                    for curl, errno, errmsg in failed:
+                        transfer, attempt = active.pop(curl)
+                        multi.remove_handle(curl)
+                        transfer.stream.close()
+                        self._unroute(transfer.endpoint, None, errno)
+                        idle.append(curl)
+                        finished = True
+
+                        if isinstance(transfer.stream, _FileSink) and (
+                            transfer.stream.error is not None
+                        ):
+                            logger.error(
+                                "An error occurred while trying to write the buffer"
+                                " to disk."
+                            )
+                            raise RuntimeError(
+                                f"Failed to write buffer data to: {transfer.dst!s}"
+                            ) from transfer.stream.error
+
+                        if attempt < retries:
+                            logger.warning(
+                                "Transfer from '%s' to '%s' failed, retrying: %s",
+                                transfer.src,
+                                transfer.dst,
+                                errmsg,
+                            )
+                            repeats.append(((transfer.src, transfer.dst), attempt + 1))
+
+                            continue
+
+                        failure: Exception
+                        if upload:
+                            logger.error(
+                                "File could not be uploaded to the FTP server."
+                            )
+                            failure = FTPError(
+                                f"Could not upload {str(transfer.src)!r} to"
+                                f" {transfer.url!r} on FTP server."
+                            )
+                        else:
+                            logger.error(
+                                "An unexpected error occurred while fetching the data."
+                            )
+                            failure = FTPError(
+                                "Encountered an error while trying to fetch the data"
+                                f" from: {transfer.url!s}"
+                            )
+                        failure.__cause__ = pycurl.error(errno, errmsg)
+                        failures.append(failure)
+
+                    if not queued:
+                        break
+
+                # Wait for socket activity unless handles became free for new pairs.
+                if not finished:
+                    multi.select(1.0)
+
+            if failures:
+                logger.error("Transfers failed after all retries: %d", len(failures))
+                raise failures[0]
+        finally:
+            # Handles are detached, so the multi handle is ready for the next batch.
+            for curl, (transfer, _) in active.items():
+                multi.remove_handle(curl)
+                transfer.stream.close()
+                self._unroute(transfer.endpoint, None)
+
+        return size_bytes
+
+    def size(self, src: str | pathlib.Path) -> int | None:
+        """Asks the server for the size of a remote file without fetching it.
+
+        Parameters
+        ----------
+        src : str or pathlib.Path
+            The FTP path to the remote file.
+
+        Returns
+        -------
+        int or None
+            The size of the file in bytes, or None if the server does not tell.
+
+        Raises
+        ------
+        FTPError
+            If any network or FTP-related issue occurs during the request.
+        """
+        curl = self._handle()
+        endpoint = self._route()
+        url = self._ensure_ftp_url(src, endpoint)
+        self._configure_download(curl, url)
+        curl.setopt(pycurl.NOBODY, 1)
+        try:
+            curl.perform()
+        except pycurl.error as err:
+            self._unroute(endpoint, None, err.args[0])
+
+            logger.exception("Failed to request the size of the remote file.")
+            raise FTPError(f"Could not determine the size of: {url!s}") from err
+
+        self._unroute(endpoint, curl)
+
+        size = int(curl.getinfo(pycurl.CONTENT_LENGTH_DOWNLOAD))
+
+        return size if size >= 0 else None
+
+    def size_many(
+        self,
+        src: typing.Iterable[str | pathlib.Path],
+        *,
+        concurrency: int | None = None,
+    ) -> list[int | None]:
+        """Asks the server for the sizes of many remote files at once.
+
+        The requests go through the multi handle of the calling thread like a
+        batch of transfers. A file whose size cannot be determined is reported
+        without one instead of failing the others.
+
+        Parameters
+        ----------
+        src : iterable of str or pathlib.Path
+            The FTP paths to the remote files.
+
+        concurrency : int, optional
+            Number of simultaneous requests, ``max_workers`` by default.
+
+        Returns
+        -------
+        list of int or None
+            The size of every file in bytes, None where the server does not tell.
+        """
+        if concurrency is None:
+            concurrency = self._connection_parameters.max_workers
+
+        paths = list(src)
+        sizes: list[int | None] = [None] * len(paths)
+
+        pending = iter(enumerate(paths))
+        multi, idle = self._batch(max(1, concurrency))
+        active: dict[pycurl.Curl, tuple[int, str, EndpointLoad]] = {}
+        try:
+            while True:
+                while idle and (item := next(pending, None)) is not None:
+                    curl = idle.pop()
+                    curl.reset()
+
+                    endpoint = self._route()
+                    url = self._ensure_ftp_url(item[1], endpoint)
+                    self._configure_download(curl, url)
+                    curl.setopt(pycurl.NOBODY, 1)
+
+                    active[curl] = (item[0], url, endpoint)
+                    multi.add_handle(curl)
+
+                if not active:
+                    break
+
+                while True:
+                    ret, _ = multi.perform()
+                    if ret != pycurl.E_CALL_MULTI_PERFORM:
+                        break
+
+                finished: bool = False
+                while True:
+                    queued, succeeded, failed = multi.info_read()
+
+                    for curl in succeeded:
+                        index, _, endpoint = active.pop(curl)
+                        multi.remove_handle(curl)
+                        self._unroute(endpoint, curl)
+                        idle.append(curl)
+                        finished = True
+
+                        size = int(curl.getinfo(pycurl.CONTENT_LENGTH_DOWNLOAD))
+                        sizes[index] = size if size >= 0 else None
+
+                    for curl, errno, errmsg in failed:
+                        _, url, endpoint = active.pop(curl)
+                        multi.remove_handle(curl)
+                        self._unroute(endpoint, None, errno)
+                        idle.append(curl)
+                        finished = True
+
+                        logger.warning(
+                            "Failed to request the size of '%s': %s", url, errmsg
+                        )
+
+                    if not queued:
+                        break
+
+                if not finished:
+                    multi.select(1.0)
+        finally:
+            for curl, (_, _, endpoint) in active.items():
+                multi.remove_handle(curl)
+                self._unroute(endpoint, None)
+
+        return sizes
+
+    def download_segmented(
+        self,
+        src: str | pathlib.Path,
+        dst: str | pathlib.Path,
+        *,
+        size: int | None = None,
+        segments: int | None = None,
+    ) -> float:
+        """Fetches a large remote file over several connections at once.
+
+        The file is split into contiguous ranges which are requested with REST on
+        separate connections and written at their offsets into a destination that
+        is preallocated to the full size. Every range is checked to be complete.
+
+        Parameters
+        ----------
+        src : str or pathlib.Path
+            The FTP path to the remote file to be downloaded.
+
+        dst : str or pathlib.Path
+            The local filesystem path where the file will be saved.
+
+        size : int, optional
+            The size of the remote file, requested from the server when omitted.
+
+        segments : int, optional
+            Number of parallel ranges, by default the sum of the session limits
+            of the server and its mirrors. Ranges are spread over the mirrors.
+
+        Returns
+        -------
+        float
+            The total number of bytes successfully downloaded.
+
+        Raises
+        ------
+        RuntimeError
+            If the destination directory cannot be created or written to.
+
+        FTPError
+            If any network or FTP-related issue occurs during download, or the
+            received data does not add up to the size of the file.
+        """
+        if size is None:
+            size = self.size(src)
+
+        if segments is None:
+            segments = sum(endpoint.limit for endpoint in self._endpoints)
+
+        # Ranges much smaller than the chunk size only add connection overhead.
+        segments = min(segments, (size or 0) // _MIN_SEGMENT_SIZE)
+        if size is None or segments <= 1:
+            return self.download(src, dst)
+
+        if dirname := os.path.dirname(os.path.expanduser(dst)):
+            try:
+                os.makedirs(dirname, exist_ok=True)
+            except OSError as err:
+                logger.exception(
+                    "Failed to create a new directory on the current machine."
+                )
+                raise RuntimeError(
+                    f"Could not create target directory: {dirname!s}"
+                ) from err
+
+        url = self._ensure_ftp_url(src)
+        logger.debug(
+            "Downloading '%s' from FTP server to '%s' in %d segments.",
+            url,
+            dst,
+            segments,
+        )
+
+        try:
+            flags = os.O_WRONLY | os.O_CREAT | os.O_TRUNC | getattr(os, "O_BINARY", 0)
+            fd = os.open(dst, flags, 0o666)
+        except OSError as err:
+            logger.exception(
+                "An error occurred while trying to write the buffer to disk."
+            )
+            raise RuntimeError(f"Failed to write buffer data to: {dst!s}") from err
+
+        step = -(-size // segments)
+        offsets = range(0, size, step)
+
+        multi, batch = self._batch(len(offsets))
+        handles: list[pycurl.Curl] = []
+        sinks: dict[pycurl.Curl, tuple[_RangeSink, int]] = {}
+        routes: dict[pycurl.Curl, EndpointLoad] = {}
+        codes: dict[pycurl.Curl, int] = {}
+        succeeded = False
+        try:
+            try:
+                if hasattr(os, "posix_fallocate"):
+                    os.posix_fallocate(fd, 0, size)
+                else:
+                    os.ftruncate(fd, size)
+            except OSError:
+                os.ftruncate(fd, size)
+
+            for curl, offset in zip(batch, offsets):
+                length = min(step, size - offset)
+
+                curl.reset()
+                routes[curl] = endpoint = self._route()
+                self._configure_download(curl, self._ensure_ftp_url(src, endpoint))
+                curl.setopt(pycurl.RANGE, f"{offset:d}-{offset + length - 1:d}")
+
+                sinks[curl] = (sink := _RangeSink(fd, offset, length), length)
+                curl.setopt(pycurl.WRITEFUNCTION, sink.write)
+                multi.add_handle(curl)
+                handles.append(curl)
+
+            running = len(handles)
+            while running:
+                while True:
+                    ret, running = multi.perform()
+                    if ret != pycurl.E_CALL_MULTI_PERFORM:
+                        break
+
+                while True:
+                    queued, _, failed = multi.info_read()
+                    for curl, errno, errmsg in failed:
+                        codes[curl] = errno
+                        sink, _ = sinks[curl]
+                        if sink.error is not None:
+                            logger.error(
+                                "An error occurred while trying to write the buffer"
+                                " to disk."
+                            )
+                            message = f"Failed to write buffer data to: {dst!s}"
+                            raise RuntimeError(message) from sink.error
+
+                        logger.error(
+                            "An unexpected error occurred while fetching the data."
+                        )
+                        raise FTPError(
+                            "Encountered an error while trying to fetch the data from:"
+                            f" {url!s}"
+                        ) from pycurl.error(errno, errmsg)
+
+                    if not queued:
+                        break
+
+                if running:
+                    multi.select(1.0)
+
+            # A server may close a data connection early without an error reply.
+            if any(sink.size != length for sink, length in sinks.values()):
+                logger.error("Segmented download finished with missing data.")
+                raise FTPError(f"Incomplete data received from: {url!s}")
+
+            for curl in handles:
+                _record_transfer(curl, False)
+            succeeded = True
+        finally:
+            for curl, endpoint in routes.items():
+                self._unroute(endpoint, curl if succeeded else None, codes.get(curl))
+            for curl in handles:
+                multi.remove_handle(curl)
+            os.close(fd)
+
+        logger.debug(
+            "Completed transfer of %d bytes from FTP location '%s' to '%s'.",
+            size,
+            url,
+            dst,
+        )
+
+        return float(size)
+
+    def download_many(
+        self,
+        src: typing.Iterable[str | pathlib.Path],
+        dst: typing.Iterable[str | pathlib.Path],
+        *,
+        concurrency: int | None = None,
+        progress: typing.Callable[[], typing.Any] | None = None,
+    ) -> float:
+        """Fetches many remote files at once from the calling thread.
+
+        Parameters
+        ----------
+        src : iterable of str or pathlib.Path
+            The FTP paths to the remote files to be downloaded.
+
+        dst : iterable of str or pathlib.Path
+            The local filesystem paths where the files will be saved.
+
+        concurrency : int, optional
+            Number of simultaneous transfers, ``max_workers`` by default.
+
+        progress : callable, optional
+            Called without arguments after every completed transfer.
+
+        Returns
+        -------
+        float
+            The total number of bytes successfully downloaded.
+
+        Raises
+        ------
+        RuntimeError
+            If a destination directory cannot be created or written to.
+
+        FTPError
+            If a download still fails after all retries, once the others are done.
+        """
+        return self._perform_many(
+            zip(src, dst, strict=True), False, concurrency, progress
+        )
+
+    def upload_many(
+        self,
+        src: typing.Iterable[str | pathlib.Path],
+        dst: typing.Iterable[str | pathlib.Path],
+        *,
+        concurrency: int | None = None,
+        progress: typing.Callable[[], typing.Any] | None = None,
+    ) -> None:
+        """Uploads many local files at once from the calling thread.
+
+        Parameters
+        ----------
+        src : iterable of str or pathlib.Path
+            Paths to the local files to upload.
+
+        dst : iterable of str or pathlib.Path
+            Paths on the FTP server where the files should be placed.
+
+        concurrency : int, optional
+            Number of simultaneous transfers, ``max_workers`` by default.
+
+        progress : callable, optional
+            Called without arguments after every completed transfer.
+
+        Raises
+        ------
+        RuntimeError
+            If reading a local file fails.
+
+        FTPError
+            If an upload still fails after all retries, once the others are done.
+        """
+        self._perform_many(zip(src, dst, strict=True), True, concurrency, progress)
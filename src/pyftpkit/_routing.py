@@ -0,0 +1,105 @@
+# -*- coding: utf-8 -*-
+
+# Copyright 2025 (c) Vladislav Punko <iam.vlad.punko@gmail.com>
+
+import time
+import typing
+
+from pyftpkit.connection_parameters import ConnectionParameters
+
+__all__ = ["EndpointLoad", "candidates", "endpoint_loads", "expected_latency"]
+
+# Weight of the newest sample in the moving average of the latency.
+_SMOOTHING: typing.Final[float] = 0.2
+
+# Pause after the first failure to reach a server, doubled on every further one.
+_COOLDOWN: typing.Final[float] = 1.0
+_MAX_COOLDOWN: typing.Final[float] = 60.0
+
+_T = typing.TypeVar("_T", bound="EndpointLoad")
+
+
+class EndpointLoad:
+    """Tracks the operations in flight on one server and its observed latency."""
+
+    __slots__ = (
+        "host",
+        "port",
+        "limit",
+        "in_flight",
+        "latency",
+        "failures",
+        "retry_at",
+    )
+
+    def __init__(self, host: str, port: int, limit: int) -> None:
+        self.host = host
+        self.port = port
+        self.limit = limit
+
+        self.in_flight: int = 0
+        self.latency: float | None = None
+
+        # Consecutive failures to reach the server and the end of its back-off.
+        self.failures: int = 0
+        self.retry_at: float = 0.0
+
+    def observe(self, seconds: float) -> None:
+        """Folds a latency sample into the moving average."""
+        if self.latency is None:
+            self.latency = seconds
+        else:
+            self.latency += _SMOOTHING * (seconds - self.latency)
+
+        self.recover()
+
+    def fail(self) -> None:
+        """Backs off from a server that could not be reached."""
+        cooldown = min(_MAX_COOLDOWN, _COOLDOWN * 2**self.failures)
+        self.retry_at = time.monotonic() + cooldown
+        self.failures += 1
+
+    def recover(self) -> None:
+        """Ends the back-off once the server answered."""
+        self.failures = 0
+        self.retry_at = 0.0
+
+    def key(self, estimate: float) -> tuple[float, float, bool]:
+        """Orders servers by the expected wait for one more operation.
+
+        The load is the share of the connection limit in use once the operation
+        starts, scaled by the latency. Servers without samples are assumed to
+        answer as fast as the others on average and win ties among equals, so
+        every server is measured early without taking all of the load.
+        """
+        load = (self.in_flight + 1) / self.limit
+        latency = estimate if self.latency is None else self.latency
+
+        return load * latency, load, self.latency is not None
+
+
+def expected_latency(endpoints: typing.Iterable[EndpointLoad]) -> float:
+    """Returns the average latency of the servers measured so far."""
+    samples = [endpoint.latency for endpoint in endpoints if endpoint.latency]
+
+    return sum(samples) / len(samples) if samples else 0.0
+
+
+def candidates(endpoints: typing.Sequence[_T]) -> list[_T]:
+    """Drops servers backing off from failures.
+
+    When every server is backing off, only the one to recover first remains, so
+    operations still fail fast instead of waiting for the back-off to end.
+    """
+    now = time.monotonic()
+    healthy = [endpoint for endpoint in endpoints if endpoint.retry_at <= now]
+
+    return healthy or [min(endpoints, key=lambda endpoint: endpoint.retry_at)]
+
+
+def endpoint_loads(connection_parameters: ConnectionParameters) -> list[EndpointLoad]:
+    """Creates the load trackers of the server and all of its mirrors."""
+    return [
+        EndpointLoad(endpoint.host, endpoint.port, endpoint.max_connections or 1)
+        for endpoint in connection_parameters.endpoints()
+    ]
@@ -4,12 +4,13 @@
 
 import argparse
 import collections
+import io
 import typing
 
 import pydantic
 import pydantic_settings
 
-__all__ = ["Credentials", "ConnectionParameters"]
+__all__ = ["Credentials", "ConnectionParameters", "Endpoint"]
 
 
 class Credentials(pydantic.BaseModel):
@@ -19,6 +20,18 @@ class Credentials(pydantic.BaseModel):
     password: pydantic.SecretStr
 
 
+class Endpoint(pydantic.BaseModel):
+    """Represents a mirror that serves the same files with the same credentials."""
+
+    host: str
+    port: pydantic.NonNegativeInt = pydantic.Field(0, gt=0)  # no ports
+    max_connections: pydantic.NonNegativeInt | None = pydantic.Field(
+        None,
+        gt=0,
+        description="session limit of this server, max_connections if not set",
+    )
+
+
 class ConnectionParameters(pydantic_settings.BaseSettings):
     """Connection parameters for establishing and managing FTP connections."""
 
@@ -39,14 +52,73 @@ class ConnectionParameters(pydantic_settings.BaseSettings):
     max_connections: pydantic.NonNegativeInt = pydantic.Field(
         10, gt=0, description="maximum number of simultaneous connections"
     )
+    min_connections: pydantic.NonNegativeInt = pydantic.Field(
+        1,
+        description=(
+            "number of connections opened upfront, more are opened on demand"
+            " up to max_connections"
+        ),
+    )
+    keepalive_interval: pydantic.NonNegativeInt = pydantic.Field(
+        60,
+        description=(
+            "seconds of idleness after which pooled connections are checked with"
+            " NOOP, 0 disables the checks"
+        ),
+    )
     max_workers: pydantic.NonNegativeInt = pydantic.Field(
         30, gt=0, description="maximum number of worker threads for parallel tasks"
     )
+    backend: typing.Literal["threads", "asyncio"] = pydantic.Field(
+        "threads",
+        description="run FTP commands in worker threads or on the event loop",
+    )
+    buffer_size: pydantic.NonNegativeInt = pydantic.Field(
+        io.DEFAULT_BUFFER_SIZE,
+        ge=1_024,
+        le=10_485_760,  # the largest receive buffer accepted by cURL
+        description="size in bytes of the cURL receive buffer for downloads",
+    )
+    preallocate: bool = pydantic.Field(
+        False, description="reserve disk space for downloads from the remote size"
+    )
+    segment_threshold: pydantic.NonNegativeInt = pydantic.Field(
+        0,
+        description=(
+            "download files of at least this many bytes in parallel segments"
+            " over all connections, 0 disables segmented downloads"
+        ),
+    )
+    retries: pydantic.NonNegativeInt = pydantic.Field(
+        2,
+        description=(
+            "times a failed transfer of a batch is repeated before it counts as"
+            " failed, the rest of the batch carries on either way"
+        ),
+    )
+    mirrors: list[Endpoint] = pydantic.Field(
+        default_factory=list,
+        description="more servers with the same files to spread operations over",
+    )
     extra_options: dict[int, str | int] = pydantic.Field(
         default_factory=dict,
         description="optional dictionary of additional cURL configuration options",
     )
 
+    def endpoints(self) -> list[Endpoint]:
+        """Returns the main server followed by its mirrors with resolved limits."""
+        main = Endpoint.model_construct(host=self.host, port=self.port)
+
+        # Everything is validated already and the main port may be left unset.
+        return [
+            Endpoint.model_construct(
+                host=endpoint.host,
+                port=endpoint.port,
+                max_connections=endpoint.max_connections or self.max_connections,
+            )
+            for endpoint in [main, *self.mirrors]
+        ]
+
     @classmethod
     def from_arguments(
         cls: type["ConnectionParameters"], arguments: argparse.Namespace
@@ -62,6 +134,12 @@ class ConnectionParameters(pydantic_settings.BaseSettings):
                 case "host" | "port" | "timeout" | "max_connections" | "max_workers":
                     overrides[key] = value
 
+                case "buffer_size" | "preallocate" | "segment_threshold" | "retries":
+                    overrides[key] = value
+
+                case "min_connections" | "keepalive_interval" | "mirrors":
+                    overrides[key] = value
+
                 case "username" | "password":
                     overrides["credentials"][key] = value
 
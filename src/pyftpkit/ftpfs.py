@@ -6,28 +6,251 @@ import asyncio
 import collections
 import ftplib
 import functools
+import itertools
 import logging
 import os
 import pathlib
+import time
 import typing
 from concurrent.futures import ThreadPoolExecutor
 
+from pyftpkit import metrics
+from pyftpkit._aioftp import AsyncFTP
 from pyftpkit._ftp import FTP
+from pyftpkit._listing import Listing, parse_listing
 from pyftpkit._pathtrie import PathTrie
-from pyftpkit._pool import FTPPoolExecutor
+from pyftpkit._pool import Connection, FTPPoolExecutor
 from pyftpkit.connection_parameters import ConnectionParameters
 from pyftpkit.exceptions import FTPError
 
-__all__ = ["FTPFileSystem"]
+__all__ = ["DirectoryCache", "FTPEntry", "FTPFileSystem"]
 
 logger = logging.getLogger("pyftpkit")
 
+_DIRECTORY: typing.Final[int] = ord("d")
+
+_ENTRY_TYPES: typing.Final[dict[int, str]] = {
+    ord("d"): "dir",
+    ord("f"): "file",
+    ord("l"): "link",
+    ord("?"): "other",
+}
+
+
+class FTPEntry(typing.NamedTuple):
+    """Describes a single entry of a remote directory listing.
+
+    Attributes
+    ----------
+    path : pathlib.Path
+        Absolute path of the entry.
+
+    type : str
+        One of dir, file, link or other.
+
+    size : int or None
+        Size in bytes if the server reported it.
+
+    mtime : int or None
+        Modification time in seconds since the epoch if the server reported it.
+    """
+
+    path: pathlib.Path
+    type: str
+    size: int | None
+    mtime: int | None
+
+
+class DirectoryCache:
+    """Remembers the remote directories known to exist during a session.
+
+    Directories are kept in a path trie, so recording a directory records all of
+    its parents as well. The cache learns from listings and from directories
+    probed or created by makedirs, and forgets whole subtrees removed by rmtree.
+    One cache can be shared by several file systems talking to the same server.
+    It is not thread-safe and belongs to the event loop.
+    """
+
+    def __init__(self) -> None:
+        self._pathtrie = PathTrie()
+
+    def __contains__(self, path: str | pathlib.Path) -> bool:
+        return os.fspath(path) == os.sep or os.fspath(path) in self._pathtrie
+
+    def add(self, path: str | pathlib.Path) -> None:
+        """Records an existing directory along with its parents."""
+        self._pathtrie.insert(os.fspath(path))
+
+    def missing(self, pathtrie: PathTrie) -> list[str]:
+        """Returns the directories of a trie not known to exist, parents first."""
+        paths = pathtrie.missing_from(self._pathtrie)
+
+        return [path for path in paths if path != os.sep]
+
+    def discard(self, path: str | pathlib.Path) -> None:
+        """Forgets a directory and everything below it."""
+        path = os.path.normpath(os.fspath(path))
+        if path not in self._pathtrie:
+            return None
+
+        # Removals are rare, so the trie is rebuilt without the subtree.
+        prefix = path.rstrip(os.sep) + os.sep
+        paths = [
+            other
+            for other in self._pathtrie
+            if other != path and not other.startswith(prefix)
+        ]
+        self._pathtrie = PathTrie()
+        self._pathtrie.insert_many(paths)
+
+    def clear(self) -> None:
+        """Forgets every directory."""
+        self._pathtrie.clear()
+
+
+# Upper bound on the number of directories one walk worker lists in a row.
+_LISTING_BATCH_SIZE: typing.Final[int] = 16
+
+# Default bound of the walk queues.
+_MAX_PENDING: typing.Final[int] = 1024
+
+# Upper bound on the number of entries one connection removes in a row.
+_REMOVAL_BATCH_SIZE: typing.Final[int] = 64
+
+# Priorities of the rmtree work items; removals go first to bound the backlog.
+_REMOVE: typing.Final[int] = 0
+_LIST: typing.Final[int] = 1
+
+
+def _retrieve_listings(
+    ftp: FTP, paths: typing.Sequence[str | pathlib.Path]
+) -> list[Listing]:
+    """Lists several directories back to back over one connection.
+
+    Directories are addressed by their path through MLSD, which saves the CWD
+    round trip per directory. LIST arguments are ambiguous once options are
+    passed, so servers without MLSD still have the working directory changed.
+    """
+    mlsd = ftp.supports("MLST")
+
+    listings = []
+    for path in paths:
+        logger.debug("Listing remote directory: %s", path)
+
+        # The raw response is parsed natively, so huge directories are not
+        # split into one Python string per line.
+        chunks: list[bytes] = []
+        if mlsd:
+            ftp.retrbinary(f"MLSD {path!s}", chunks.append)
+        else:
+            ftp.cwd(str(path))
+            ftp.retrbinary("LIST -a", chunks.append)
+
+        started = time.perf_counter()
+        listing = parse_listing(
+            b"".join(chunks), format="mlsd" if mlsd else "auto", encoding=ftp.encoding
+        )
+        metrics.observe("listing_parse_seconds", time.perf_counter() - started)
+        metrics.observe("listing_entries", len(listing))
+        logger.debug("Received %d directory entries.", len(listing))
+
+        listings.append(listing)
+
+    return listings
+
+
+async def _retrieve_listings_async(
+    ftp: AsyncFTP, paths: typing.Sequence[str | pathlib.Path]
+) -> list[Listing]:
+    """Lists several directories back to back over one event loop connection."""
+    mlsd = await ftp.supports("MLST")
+
+    listings = []
+    for path in paths:
+        logger.debug("Listing remote directory: %s", path)
+
+        chunks: list[bytes] = []
+        if mlsd:
+            await ftp.retrbinary(f"MLSD {path!s}", chunks.append)
+        else:
+            await ftp.cwd(str(path))
+            await ftp.retrbinary("LIST -a", chunks.append)
+
+        started = time.perf_counter()
+        listing = parse_listing(
+            b"".join(chunks), format="mlsd" if mlsd else "auto", encoding=ftp.encoding
+        )
+        metrics.observe("listing_parse_seconds", time.perf_counter() - started)
+        metrics.observe("listing_entries", len(listing))
+        logger.debug("Received %d directory entries.", len(listing))
+
+        listings.append(listing)
+
+    return listings
+
+
+def _removal_error(is_dir: bool, path: str) -> FTPError:
+    """Logs the active FTP failure of a removal and builds the error to raise."""
+    if is_dir:
+        logger.exception(
+            "Could not remove directory because of an unexpected FTP error."
+        )
+        return FTPError(f"Failed to remove directory {path!r} from the FTP server.")
+
+    logger.exception("Could not delete file due to an unexpected FTP server response.")
+    return FTPError(f"FTP server refused to delete file: {path!s}")
+
+
+def _remove_entries(ftp: FTP, entries: typing.Sequence[tuple[bool, str]]) -> None:
+    """Removes files and empty directories in turn over a single connection."""
+    for is_dir, path in entries:
+        logger.debug("Attempting to delete: %s", path)
+        try:
+            if is_dir:
+                ftp.rmd(path)
+            else:
+                ftp.delete(path)
+        except ftplib.all_errors as err:
+            raise _removal_error(is_dir, path) from err
+
+        if is_dir:
+            logger.debug("Remote directory removed: %s", path)
+        else:
+            logger.debug("File deletion succeeded: %s", path)
+
+
+async def _remove_entries_async(
+    ftp: AsyncFTP, entries: typing.Sequence[tuple[bool, str]]
+) -> None:
+    """Asyncio counterpart of _remove_entries for the asyncio backend."""
+    for is_dir, path in entries:
+        logger.debug("Attempting to delete: %s", path)
+        try:
+            if is_dir:
+                await ftp.rmd(path)
+            else:
+                await ftp.delete(path)
+        except ftplib.all_errors as err:
+            raise _removal_error(is_dir, path) from err
+
+        if is_dir:
+            logger.debug("Remote directory removed: %s", path)
+        else:
+            logger.debug("File deletion succeeded: %s", path)
+
+
+_WalkItem: typing.TypeAlias = (
+    tuple[pathlib.Path, list[pathlib.Path], list[pathlib.Path]]
+    | tuple[pathlib.Path, list[FTPEntry], list[FTPEntry]]
+)
+
 
 class FTPFileSystem:
     """Provides an FTP-backed virtual file system interface.
 
     This class emulates standard file system operations for files
-    stored on a remote FTP server.
+    stored on a remote FTP server. Directories seen along the way are kept in a
+    directory cache, pass the same cache to several instances to share it.
     """
 
     def __init__(
@@ -35,9 +258,12 @@ class FTPFileSystem:
         connection_parameters: ConnectionParameters,
         *,
         executor: ThreadPoolExecutor | None = None,
+        directories: DirectoryCache | None = None,
     ) -> None:
         self._connection_parameters = connection_parameters
 
+        self._directories = DirectoryCache() if directories is None else directories
+
         # Initialize a managed pool of pre-authenticated FTP connections. This design
         # drastically reduces the overhead of repeated handshakes and logins.
         self._pool = FTPPoolExecutor(
@@ -52,45 +278,118 @@ class FTPFileSystem:
     async def __aexit__(self, *args: typing.Any, **kwargs: typing.Any) -> None:
         await self._pool.close()
 
-    async def _listdir(
-        self, path: str | pathlib.Path, ftp: FTP
-    ) -> tuple[list[pathlib.Path], list[pathlib.Path]]:
-        """Retrieve the directory contents from the remote FTP server."""
+    async def _call(
+        self, ftp: Connection, method: str, *args: typing.Any
+    ) -> typing.Any:
+        """Run an FTP command on the event loop or in the pool executor.
+
+        Clients of the asyncio backend never block, so their commands are awaited
+        directly instead of paying for a thread hop.
+        """
+        if isinstance(ftp, AsyncFTP):
+            return await getattr(ftp, method)(*args)
+
         loop = asyncio.get_running_loop()
 
-        logger.debug("Listing remote directory: %s", path)
+        return await loop.run_in_executor(
+            self._pool.executor, functools.partial(getattr(ftp, method), *args)
+        )
 
-        await loop.run_in_executor(self._pool.executor, ftp.cwd, str(path))
+    @property
+    def directories(self) -> DirectoryCache:
+        """Returns the cache of the remote directories known to exist."""
+        return self._directories
+
+    async def _list(
+        self, paths: typing.Sequence[str | pathlib.Path], ftp: Connection
+    ) -> list[Listing]:
+        """Retrieve and parse the raw directory listings from the remote FTP server."""
+        if isinstance(ftp, AsyncFTP):
+            listings = await _retrieve_listings_async(ftp, paths)
+        else:
+            loop = asyncio.get_running_loop()
+
+            # All directories are listed within a single executor job, so a batch
+            # costs one hop between the event loop and the pool regardless of size.
+            listings = await loop.run_in_executor(
+                self._pool.executor, functools.partial(_retrieve_listings, ftp, paths)
+            )
 
-        entries: list[str] = []
-        await loop.run_in_executor(
-            self._pool.executor, ftp.retrlines, "LIST -a", entries.append
+        # Only directories can be listed.
+        for path in paths:
+            self._directories.add(path)
+
+        return listings
+
+    async def _remove(
+        self, entries: typing.Sequence[tuple[bool, str]], ftp: Connection
+    ) -> None:
+        """Remove a batch of files and empty directories on one connection."""
+        if isinstance(ftp, AsyncFTP):
+            return await _remove_entries_async(ftp, entries)
+
+        loop = asyncio.get_running_loop()
+
+        return await loop.run_in_executor(
+            self._pool.executor, functools.partial(_remove_entries, ftp, entries)
         )
-        logger.debug(repr(entries))
 
+    @staticmethod
+    def _split_paths(
+        dirpath: pathlib.Path, listing: Listing
+    ) -> tuple[list[pathlib.Path], list[pathlib.Path]]:
+        """Split a parsed listing into directory and non-directory paths."""
         dirs = []
         nondirs = []
-        for entry in entries:
-            # Skip empty or malformed lines.
-            # A valid line begins with a 10-character permission field.
-            if not entry or len(entry) < 10:
-                continue
-
-            name = entry.strip().split(maxsplit=8).pop()
-            if name in (".", ".."):
-                continue
-
-            if entry.startswith("l"):
-                name, _ = name.split(" -> ", maxsplit=1)
-
-            abspath = pathlib.Path(path) / name
-            if entry.startswith("d"):
-                dirs.append(abspath)
+
+        for name, kind in zip(listing.names, listing.types):
+            if kind == _DIRECTORY:
+                dirs.append(dirpath / name)
+            else:
+                nondirs.append(dirpath / name)
+
+        return dirs, nondirs
+
+    @staticmethod
+    def _split_entries(
+        dirpath: pathlib.Path, listing: Listing
+    ) -> tuple[list[FTPEntry], list[FTPEntry]]:
+        """Split a parsed listing into directory and non-directory entries."""
+        dirs = []
+        nondirs = []
+
+        for name, kind, size, mtime in zip(
+            listing.names, listing.types, listing.sizes, listing.mtimes
+        ):
+            entry = FTPEntry(
+                path=dirpath / name,
+                type=_ENTRY_TYPES[kind],
+                size=size if size >= 0 else None,
+                mtime=mtime if mtime >= 0 else None,
+            )
+            if kind == _DIRECTORY:
+                dirs.append(entry)
             else:
-                nondirs.append(abspath)
+                nondirs.append(entry)
 
         return dirs, nondirs
 
+    async def _listdir(
+        self, path: str | pathlib.Path, ftp: Connection
+    ) -> tuple[list[pathlib.Path], list[pathlib.Path]]:
+        """Retrieve the directory contents from the remote FTP server."""
+        (listing,) = await self._list([path], ftp=ftp)
+
+        return self._split_paths(pathlib.Path(path), listing)
+
+    async def _scandir(
+        self, path: str | pathlib.Path, ftp: Connection
+    ) -> tuple[list[FTPEntry], list[FTPEntry]]:
+        """Retrieve the directory entries and their metadata from the FTP server."""
+        (listing,) = await self._list([path], ftp=ftp)
+
+        return self._split_entries(pathlib.Path(path), listing)
+
     async def listdir(
         self, path: str | pathlib.Path
     ) -> tuple[list[pathlib.Path], list[pathlib.Path]]:
@@ -124,44 +423,114 @@ class FTPFileSystem:
         finally:
             await self._pool.release(ftp)
 
-    async def walk(  # noqa: C901
+    async def scandir(
         self, path: str | pathlib.Path
-    ) -> typing.AsyncIterator[
-        tuple[pathlib.Path, list[pathlib.Path], list[pathlib.Path]]
-    ]:
+    ) -> tuple[list[FTPEntry], list[FTPEntry]]:
+        """Lists the contents of a remote FTP directory with their metadata.
+
+        Sizes and modification times come with the listing itself when the
+        server supports MLSD, so no extra command is issued per entry.
+
+        Parameters
+        ----------
+        path : str or pathlib.Path
+            Remote directory path to list.
+
+        Returns
+        -------
+        tuple[list[FTPEntry], list[FTPEntry]]
+            - A list of directory entries.
+            - A list of non-directory (files) entries.
+
+        Raises
+        ------
+        FTPError
+            If an FTP-related error occurs during listing.
+        """
+        ftp = await self._pool.get()
+        try:
+            return await self._scandir(path, ftp=ftp)
+        except ftplib.all_errors as err:
+            logger.exception(
+                "The FTP server returned an error during directory listing."
+            )
+            raise FTPError(f"Failed to list this directory: {path!s}") from err
+
+        finally:
+            await self._pool.release(ftp)
+
+    async def walk(  # noqa: C901
+        self,
+        path: str | pathlib.Path,
+        *,
+        details: bool = False,
+        max_pending: int = _MAX_PENDING,
+        prune: typing.Callable[[FTPEntry], bool] | None = None,
+    ) -> typing.AsyncIterator[_WalkItem]:
         """Asynchronously traverses a remote FTP directory tree.
 
         - Uses worker coroutines to parallelize listing operations across
           multiple FTP connections managed by the connection pool.
 
+        - Listed directories wait in a bounded queue, so workers pause while
+          the consumer lags behind instead of buffering the whole tree.
+
         - Traversal stops when all directories have been processed or when
-          an explicit stop signal is triggered.
+          a worker fails.
 
         Parameters
         ----------
         path : str or pathlib.Path
             Root directory path on the remote FTP server to begin traversal.
 
+        details : bool, default=False
+            Yield FTPEntry objects carrying the type, size and modification time
+            of every entry instead of bare paths.
+
+        max_pending : int, default=1024
+            Maximum number of listed directories waiting to be consumed and of
+            discovered directories queued for listing. Subdirectories beyond
+            that stay with the worker that found them, which walks them depth
+            first, so they take up to the entries of the directories along
+            one branch of the tree rather than a whole level of it.
+
+        prune : callable, optional
+            Called with every subdirectory entry; the walk does not descend into
+            the directories it returns True for. They are still yielded as
+            entries of their parent. Requires details.
+
         Yields
         ------
         tuple[pathlib.Path, list[pathlib.Path], list[pathlib.Path]]
             - The current directory path.
-            - A list of subdirectory paths under the current directory.
-            - A list of file paths under the current directory.
+            - A list of subdirectory paths or entries under the current directory.
+            - A list of file paths or entries under the current directory.
 
         Raises
         ------
+        ValueError
+            If max_pending is not a positive number or prune is given without
+            details.
+
         RuntimeError
             If an FTP worker encounters a critical error.
         """
-        stop_event = asyncio.Event()
+        if max_pending <= 0:
+            raise ValueError("The number of pending directories must be positive.")
 
-        queue: asyncio.Queue[pathlib.Path] = asyncio.Queue()
-        await queue.put(pathlib.Path(path))
+        if prune is not None and not details:
+            raise ValueError("Pruning the walk requires details to be enabled.")
 
-        output_queue: asyncio.Queue[
-            tuple[pathlib.Path, list[pathlib.Path], list[pathlib.Path]] | Exception
-        ] = asyncio.Queue()
+        queue: asyncio.Queue[pathlib.Path] = asyncio.Queue(maxsize=max_pending)
+        queue.put_nowait(pathlib.Path(path))
+
+        output_queue: asyncio.Queue[_WalkItem | Exception | None] = asyncio.Queue(
+            maxsize=max_pending
+        )
+
+        # Directories that have been discovered but not yet yielded. The walk is
+        # over once the count drops to zero, which needs no polling.
+        pending = 1
 
         async def _worker() -> None:
             """Worker coroutine that retrieves directories from the task queue.
@@ -169,39 +538,86 @@ class FTPFileSystem:
             This coroutine is defined as an inner function to simplify binding
             to the correct event loop.
             """
-            ftp = await self._pool.get()
+            nonlocal pending
+
+            # Subdirectories that did not fit into the full shared queue. The
+            # oldest are handed back as soon as there is room again, while the
+            # worker goes on with the newest, so the backlog grows with the
+            # depth of the tree rather than its width.
+            backlog: collections.deque[pathlib.Path] = collections.deque()
+
+            # A failure to connect ends the walk like any other error.
+            ftp: Connection | None = None
             try:
+                ftp = await self._pool.get()
                 while True:
-                    try:
-                        dirpath = await queue.get()
-                        logger.debug("Processing directory from queue: %s", dirpath)
-                    except asyncio.CancelledError:
-                        break
-
-                    try:
-                        dirs, nondirs = await self._listdir(dirpath, ftp=ftp)
-                        logger.debug(repr(dirs))
-                        logger.debug(repr(nondirs))
-                        await output_queue.put((pathlib.Path(dirpath), dirs, nondirs))
-                        for subdirpath in dirs:
-                            await queue.put(subdirpath)
-                    except Exception:
-                        logger.exception(
-                            "An unexpected error occurred at this program runtime."
-                        )
-                        stop_event.set()
-                        await output_queue.put(
-                            Exception("FTP walk worker encountered an error.")
-                        )
+                    while backlog and not queue.full():
+                        queue.put_nowait(backlog.popleft())
+
+                    if backlog:
+                        dirpaths = [backlog.pop()]
+                    else:
+                        dirpaths = [await queue.get()]
+
+                    # Take a fair share of the backlog at once, so the directories
+                    # are listed back to back over this connection.
+                    batch_size = min(
+                        _LISTING_BATCH_SIZE,
+                        1 + queue.qsize() // self._connection_parameters.max_workers,
+                    )
+                    while len(dirpaths) < batch_size and not queue.empty():
+                        dirpaths.append(queue.get_nowait())
 
-                        break
-                    finally:
-                        queue.task_done()
+                    for dirpath in dirpaths:
+                        logger.debug("Processing directory from queue: %s", dirpath)
 
-                    if stop_event.is_set():
-                        break
+                    metrics.gauge("walk_queue_depth", queue.qsize())
+                    metrics.gauge("walk_output_queue_depth", output_queue.qsize())
+
+                    listings = await self._list(dirpaths, ftp=ftp)
+
+                    for dirpath, listing in zip(dirpaths, listings):
+                        output: _WalkItem
+                        if details:
+                            entries = self._split_entries(dirpath, listing)
+                            subdirpaths = [
+                                entry.path
+                                for entry in entries[0]
+                                if prune is None or not prune(entry)
+                            ]
+                            output = (dirpath, entries[0], entries[1])
+                        else:
+                            dirs, nondirs = self._split_paths(dirpath, listing)
+                            subdirpaths = dirs
+                            output = (dirpath, dirs, nondirs)
+                        # Formatting huge listings costs more than listing them.
+                        if logger.isEnabledFor(logging.DEBUG):
+                            logger.debug(repr(output[1]))
+                            logger.debug(repr(output[2]))
+
+                        # Blocks while the consumer is behind.
+                        await output_queue.put(output)
+
+                        for subdirpath in subdirpaths:
+                            try:
+                                queue.put_nowait(subdirpath)
+                            except asyncio.QueueFull:
+                                backlog.append(subdirpath)
+
+                        # Subdirectories are counted before their parent is
+                        # released, so the count never reaches zero early.
+                        pending += len(subdirpaths) - 1
+
+                    if pending == 0:
+                        await output_queue.put(None)
+            except Exception as err:
+                logger.exception(
+                    "An unexpected error occurred at this program runtime."
+                )
+                await output_queue.put(err)
             finally:
-                await self._pool.release(ftp)
+                if ftp is not None:
+                    await self._pool.release(ftp)
 
         # Spawn worker tasks.
         workers = [
@@ -210,74 +626,39 @@ class FTPFileSystem:
         ]
 
         try:
-            # Create a task to wait for all directories to be processed.
-            join_task = asyncio.create_task(queue.join())
-
-            # Wait until all tasks in the queue are done or an exception occurs.
-            while not join_task.done():
-                if stop_event.is_set():
-                    break
-
-                try:
-                    # Short timeout to periodically check stop event.
-                    output = await asyncio.wait_for(output_queue.get(), timeout=0.1)
-
-                    if isinstance(output, Exception):
-                        raise RuntimeError("Walk worker error.") from output
-
-                    yield output
-
-                    output_queue.task_done()
-                except asyncio.TimeoutError:
-                    # Re-enter the loop to inspect the join task and check
-                    # for the stop event.
-                    pass
+            while (output := await output_queue.get()) is not None:
+                if isinstance(output, Exception):
+                    raise RuntimeError("Walk worker error.") from output
 
-            await join_task
+                yield output
         finally:
-            stop_event.set()  # signal all workers to stop
-
             for worker in workers:
                 worker.cancel()
             await asyncio.gather(*workers, return_exceptions=True)
 
-            # Drain any remaining items that might have been
-            # placed onto the output queue before the workers were signaled to stop.
-            while not output_queue.empty():
-                output = await output_queue.get()
-
-                if isinstance(output, Exception):
-                    raise RuntimeError("Walk worker error.") from output
-
-                yield output
+    async def _probe(self, ftp: Connection, dirpath: str) -> bool:
+        """Checks whether a remote directory exists by changing into it."""
+        try:
+            await self._call(ftp, "cwd", dirpath)
+        except ftplib.all_errors:
+            return False
 
-                output_queue.task_done()
+        return True
 
-    @functools.singledispatchmethod
-    async def makedirs(self, paths: typing.Collection[str | pathlib.Path]) -> None:
-        """Recursively creates multiple directories on the remote FTP server."""
-        loop = asyncio.get_running_loop()
+    async def _makedirs(self, dirpaths: list[str], created: set[str]) -> None:
+        """Creates directories one after another over a single pooled connection.
 
+        Directories whose parent has just been created cannot exist yet, so they
+        are created without probing for them first.
+        """
         ftp = await self._pool.get()
         try:
-            pathtrie = PathTrie()
-            for path in paths:
-                pathtrie.insert(os.path.normpath(path))
-
-            for dirpath in pathtrie:
-                if dirpath == os.sep:
-                    continue
-
-                try:
-                    await loop.run_in_executor(
-                        self._pool.executor, ftp.cwd, str(dirpath)
-                    )
-                except ftplib.all_errors:
+            for dirpath in dirpaths:
+                fresh = os.path.dirname(dirpath) in created
+                if fresh or not await self._probe(ftp, dirpath):
                     try:
                         logger.debug("Creating a new directory: %s", dirpath)
-                        await loop.run_in_executor(
-                            self._pool.executor, ftp.mkd, str(dirpath)
-                        )
+                        await self._call(ftp, "mkd", str(dirpath))
                         logger.debug(
                             "Successfully created a new remote directory: %s", dirpath
                         )
@@ -286,9 +667,51 @@ class FTPFileSystem:
                         raise FTPError(
                             f"Unable to create directory on FTP server: {dirpath!s}."
                         ) from err
+
+                    created.add(dirpath)
+
+                self._directories.add(dirpath)
         finally:
             await self._pool.release(ftp)
 
+    @functools.singledispatchmethod
+    async def makedirs(self, paths: typing.Collection[str | pathlib.Path]) -> None:
+        """Recursively creates multiple directories on the remote FTP server."""
+        loop = asyncio.get_running_loop()
+
+        # Paths are normalized natively and the trie is built without holding
+        # the GIL, so the event loop keeps running during large batches. Big
+        # batches are sharded across all available cores.
+        pathtrie = PathTrie()
+        await loop.run_in_executor(
+            self._pool.executor,
+            functools.partial(pathtrie.insert_many, paths, threads=0),
+        )
+
+        # Directories known to exist need no round trip at all. The rest come
+        # parents first, and all directories of the same depth are independent
+        # of each other once their parents exist, so every level is spread
+        # across the whole pool.
+        levels: dict[int, list[str]] = collections.defaultdict(list)
+        for dirpath in self._directories.missing(pathtrie):
+            levels[dirpath.count(os.sep)].append(dirpath)
+
+        created: set[str] = set()
+        for _, dirpaths in sorted(levels.items()):
+            workers = min(len(dirpaths), self._connection_parameters.max_connections)
+            tasks = [
+                asyncio.create_task(self._makedirs(dirpaths[index::workers], created))
+                for index in range(workers)
+            ]
+            try:
+                await asyncio.gather(*tasks)
+            except BaseException:
+                for task in tasks:
+                    task.cancel()
+                await asyncio.gather(*tasks, return_exceptions=True)
+
+                raise
+
     @makedirs.register(pathlib.Path)
     @makedirs.register(str)
     async def _(self, path: str | pathlib.Path) -> None:
@@ -322,12 +745,10 @@ class FTPFileSystem:
         FTPError
             If the FTP server refuses the deletion or an unexpected FTP error occurs.
         """
-        loop = asyncio.get_event_loop()
-
         ftp = await self._pool.get()
         try:
             logger.debug("Attempting to delete: %s", path)
-            await loop.run_in_executor(self._pool.executor, ftp.delete, str(path))
+            await self._call(ftp, "delete", str(path))
             logger.debug("File deletion succeeded: %s", path)
         except ftplib.all_errors as err:
             logger.exception(
@@ -340,6 +761,16 @@ class FTPFileSystem:
     async def rmtree(self, path: str | pathlib.Path) -> None:
         """Recursively removes a directory tree from the remote FTP server.
 
+        - Every worker holds one pooled connection and both lists directories
+          and removes entries, so files are deleted while the tree is still
+          being listed. Removals are served before listings to keep the
+          backlog of known but undeleted entries small.
+
+        - Every directory holds a reference count in a path trie for its
+          pending listing and for each entry it contains. Once the count drops
+          to zero, the directory is empty and gets removed in turn, which then
+          releases its parent, so directories go away bottom-up in parallel.
+
         Parameters
         ----------
         path : str or pathlib.Path
@@ -351,50 +782,132 @@ class FTPFileSystem:
             Occurs if deletion of any file or directory fails due to FTP-related
             errors or access restrictions.
         """
-        loop = asyncio.get_running_loop()
-
-        dirs: collections.deque[pathlib.Path] = collections.deque()
-        nondirs: list[pathlib.Path] = []
+        root = str(pathlib.Path(path))
 
-        async for dirpath, _, other in self.walk(path):
-            nondirs.extend(other)
-            dirs.append(dirpath)
+        # Whatever part of the tree is gone afterwards, none of it is known to
+        # exist any longer.
+        try:
+            await self._rmtree(root)
+        finally:
+            self._directories.discard(root)
 
-        if nondirs:
-            logger.debug("Deleting %d files from the FTP server...", len(nondirs))
-            completed_tasks, pending_tasks = await asyncio.wait(
-                [asyncio.create_task(self.rm(path)) for path in nondirs],
-                return_when=asyncio.ALL_COMPLETED,
-            )
+    async def _rmtree(self, root: str) -> None:  # noqa: C901
+        """Removes a directory tree with every worker on its own connection."""
+        pathtrie = PathTrie()
+        pathtrie.add_ref(root)
 
-            # Cancel anything still pending (should be none).
-            for task in pending_tasks:
-                task.cancel()
+        # Items are ordered by priority first, then by submission order.
+        queue: asyncio.PriorityQueue[tuple[int, int, bool, str]] = (
+            asyncio.PriorityQueue()
+        )
+        sequence = itertools.count()
+        done = asyncio.Event()
+        errors: list[Exception] = []
+        removed = collections.Counter[bool]()
+
+        def submit(priority: int, is_dir: bool, entry: str) -> None:
+            queue.put_nowait((priority, next(sequence), is_dir, entry))
+
+        def release(dirpath: str) -> list[tuple[bool, str]]:
+            """Drops a reference and returns the directory if it became empty."""
+            if pathtrie.release(dirpath):
+                return []
+
+            # The root directory of the server itself is never removed.
+            if dirpath == os.sep:
+                done.set()
+                return []
+
+            return [(True, dirpath)]
+
+        async def remove(entries: list[tuple[bool, str]], ftp: Connection) -> None:
+            while entries:
+                await self._remove(entries, ftp)
+
+                ready: list[tuple[bool, str]] = []
+                for is_dir, entry in entries:
+                    removed[is_dir] += 1
+                    if entry == root:
+                        done.set()
+                    else:
+                        # Directories emptied by this batch are removed right
+                        # away over the same connection.
+                        ready.extend(release(os.path.dirname(entry)))
+                entries = ready
+
+        async def scan(dirpaths: list[str], ftp: Connection) -> None:
+            try:
+                listings = await self._list(dirpaths, ftp=ftp)
+            except ftplib.all_errors as err:
+                logger.exception(
+                    "The FTP server returned an error during directory listing."
+                )
+                raise FTPError(
+                    f"Failed to list this directory: {', '.join(dirpaths)!s}"
+                ) from err
+
+            for dirpath, listing in zip(dirpaths, listings):
+                dirs, nondirs = self._split_paths(pathlib.Path(dirpath), listing)
+
+                # The directory stays referenced by its own listing until all of
+                # its entries are accounted for.
+                if dirs or nondirs:
+                    pathtrie.add_ref(dirpath, len(dirs) + len(nondirs))
+                for subdir in dirs:
+                    pathtrie.add_ref(str(subdir))
+                    submit(_LIST, True, str(subdir))
+                for nondir in nondirs:
+                    submit(_REMOVE, False, str(nondir))
+
+                for is_dir, entry in release(dirpath):
+                    submit(_REMOVE, is_dir, entry)
+
+        async def worker() -> None:
+            ftp: Connection | None = None
+            try:
+                ftp = await self._pool.get()
+                while True:
+                    items = [await queue.get()]
+                    while len(items) < _REMOVAL_BATCH_SIZE and not queue.empty():
+                        items.append(queue.get_nowait())
+
+                    # Listings in the batch beyond the usual share go back to the
+                    # queue for other connections.
+                    dirpaths = [entry for prio, _, _, entry in items if prio == _LIST]
+                    for dirpath in dirpaths[_LISTING_BATCH_SIZE:]:
+                        submit(_LIST, True, dirpath)
+
+                    await remove(
+                        [(d, entry) for prio, _, d, entry in items if prio == _REMOVE],
+                        ftp,
+                    )
+                    if dirpaths:
+                        await scan(dirpaths[:_LISTING_BATCH_SIZE], ftp)
+            except Exception as err:
+                errors.append(err)
+                done.set()
+            finally:
+                if ftp is not None:
+                    await self._pool.release(ftp)
 
-            for task in completed_tasks:
-                if task.exception() is not None:
-                    raise RuntimeError(
-                        "A file deletion task failed on the FTP server."
-                    ) from task.exception()
+        submit(_LIST, True, root)
 
-        ftp = await self._pool.get()
+        workers = [
+            asyncio.create_task(worker())
+            for _ in range(self._connection_parameters.max_connections)
+        ]
         try:
-            logger.debug("Deleting %d directories...", len(dirs))
-            while dirs:
-                dirpath = dirs.pop()
+            # The tree is gone once the root is released, and only idle workers
+            # remain to be cancelled.
+            await done.wait()
+        finally:
+            for task in workers:
+                task.cancel()
+            await asyncio.gather(*workers, return_exceptions=True)
 
-                if str(dirpath) == os.sep:
-                    continue
+        if errors:
+            raise errors[0]
 
-                logger.debug("Attempting to delete: %s", dirpath)
-                await loop.run_in_executor(self._pool.executor, ftp.rmd, str(dirpath))
-                logger.debug("Remote directory removed: %s", dirpath)
-        except ftplib.all_errors as err:
-            logger.exception(
-                "Could not remove directory because of an unexpected FTP error."
-            )
-            raise FTPError(
-                f"Failed to remove directory {str(path)!r} from the FTP server."
-            ) from err
-        finally:
-            await self._pool.release(ftp)
+        logger.debug(
+            "Deleted %d files and %d directories.", removed[False], removed[True]
+        )
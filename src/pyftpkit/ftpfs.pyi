@@ -6,9 +6,24 @@ import pathlib
 import typing
 from concurrent.futures import ThreadPoolExecutor
 
+from pyftpkit._pathtrie import PathTrie
 from pyftpkit.connection_parameters import ConnectionParameters
 
-__all__: list[str] = ["FTPFileSystem"]
+__all__: list[str] = ["DirectoryCache", "FTPEntry", "FTPFileSystem"]
+
+class DirectoryCache:
+    def __init__(self) -> None: ...
+    def __contains__(self, path: str | pathlib.Path) -> bool: ...
+    def add(self, path: str | pathlib.Path) -> None: ...
+    def missing(self, pathtrie: PathTrie) -> list[str]: ...
+    def discard(self, path: str | pathlib.Path) -> None: ...
+    def clear(self) -> None: ...
+
+class FTPEntry(typing.NamedTuple):
+    path: pathlib.Path
+    type: str
+    size: int | None
+    mtime: int | None
 
 class FTPFileSystem:
     def __init__(
@@ -16,18 +31,38 @@ class FTPFileSystem:
         connection_parameters: ConnectionParameters,
         *,
         executor: ThreadPoolExecutor | None = None,
+        directories: DirectoryCache | None = None,
     ) -> None: ...
     async def __aenter__(self) -> FTPFileSystem: ...
     async def __aexit__(self, *args: typing.Any, **kwargs: typing.Any) -> None: ...
+    @property
+    def directories(self) -> DirectoryCache: ...
     async def listdir(
         self, path: str | pathlib.Path
     ) -> tuple[list[pathlib.Path], list[pathlib.Path]]: ...
-    def walk(
+    async def scandir(
         self, path: str | pathlib.Path
+    ) -> tuple[list[FTPEntry], list[FTPEntry]]: ...
+    @typing.overload
+    def walk(
+        self,
+        path: str | pathlib.Path,
+        *,
+        details: typing.Literal[False] = False,
+        max_pending: int = 1024,
     ) -> typing.AsyncIterator[
         tuple[pathlib.Path, list[pathlib.Path], list[pathlib.Path]]
     ]: ...
     @typing.overload
+    def walk(
+        self,
+        path: str | pathlib.Path,
+        *,
+        details: typing.Literal[True],
+        max_pending: int = 1024,
+        prune: typing.Callable[[FTPEntry], bool] | None = None,
+    ) -> typing.AsyncIterator[tuple[pathlib.Path, list[FTPEntry], list[FTPEntry]]]: ...
+    @typing.overload
     async def makedirs(self, paths: typing.Collection[str | pathlib.Path]) -> None: ...
     @typing.overload
     async def makedirs(self, path: str | pathlib.Path) -> None: ...
@@ -3,21 +3,30 @@
 # Copyright 2025 (c) Vladislav Punko <iam.vlad.punko@gmail.com>
 
 import asyncio
+import contextlib
 import functools
 import logging
 import os
 import pathlib
+import tempfile
+import threading
 import typing
 from concurrent.futures import ThreadPoolExecutor
 
+from pyftpkit import _packing
+from pyftpkit._pathtrie import PathTrie
 from pyftpkit._pycurl import PycURL
 from pyftpkit.connection_parameters import ConnectionParameters
-from pyftpkit.ftpfs import FTPFileSystem
+from pyftpkit.exceptions import FTPError
+from pyftpkit.ftpfs import DirectoryCache, FTPEntry, FTPFileSystem
 
 __all__ = ["FTPLoader"]
 
 logger = logging.getLogger("pyftpkit")
 
+# Number of discovered files allowed to wait for a transfer in pipelined mode.
+_MAX_PENDING: typing.Final[int] = 1024
+
 
 def _is_dirpath(path: str | pathlib.Path) -> bool:
     """Detects if a path is a directory using its trailing slash or separator."""
@@ -32,11 +41,85 @@ def _is_dirpath(path: str | pathlib.Path) -> bool:
     return True
 
 
+def _scan_local(path: pathlib.Path) -> tuple[list[pathlib.Path], list[pathlib.Path]]:
+    """Splits the entries of a local directory into directories and files."""
+    dirs: list[pathlib.Path] = []
+    files: list[pathlib.Path] = []
+    with os.scandir(path) as entries:
+        for entry in entries:
+            if entry.is_dir():
+                dirs.append(pathlib.Path(entry.path))
+            elif entry.is_file():
+                files.append(pathlib.Path(entry.path))
+
+    dirs.sort()
+    files.sort()
+
+    return dirs, files
+
+
+def _local_size(path: pathlib.Path) -> int | None:
+    """Returns the size of a local file or None if it cannot be determined."""
+    try:
+        return path.stat().st_size
+    except OSError:
+        return None
+
+
+def _longest_first(sizes: typing.Sequence[int | None]) -> list[int]:
+    """Orders the indices of a batch by decreasing size, unknown sizes last.
+
+    A batch runs in a window of transfers that take the next file as soon as one
+    finishes. Starting the largest files first keeps one of them from running
+    alone at the end, while the small files fill the remaining slots.
+    """
+    return sorted(range(len(sizes)), key=lambda i: (sizes[i] is None, -(sizes[i] or 0)))
+
+
+def _is_synced(
+    entry: FTPEntry, record: tuple[int, int, bool] | None, path: str
+) -> bool:
+    """Checks whether a remote file is unchanged since it was indexed and copied."""
+    if record is None or entry.size is None or entry.mtime is None:
+        return False
+
+    if record != (entry.size, entry.mtime, False):
+        return False
+
+    try:
+        return os.stat(path).st_size == entry.size
+    except OSError:
+        return False
+
+
+def _carry_over(previous: PathTrie, current: PathTrie, pruned: set[str]) -> None:
+    """Copies the records below directories the walk did not descend into.
+
+    Paths come parents first with every subtree in one run, so a single pass
+    finds all of them.
+    """
+    prefix: str | None = None
+    for path in previous:
+        if prefix is not None and path.startswith(prefix):
+            if (record := previous.metadata(path)) is not None:
+                size, mtime, is_dir = record
+                current.set_metadata(path, size, mtime, is_dir=is_dir)
+
+            continue
+
+        prefix = path.rstrip("/") + "/" if path in pruned else None
+
+
 class FTPLoader:
     """Asynchronous FTP loader for performing concurrent file system operations.
 
     Provides an interface for FTP file uploads and downloads with configurable
     concurrency and periodic progress logging.
+
+    Used as an asynchronous context manager, the loader keeps one pool of FTP
+    sessions open for listings and directory creation across all operations,
+    next to the cURL handles of the transfers, and closes both on exit. Outside
+    of a context every operation opens and closes a pool of its own.
     """
 
     DEFAULT_LOGGER_INTERVAL: typing.Final[int] = int(
@@ -62,6 +145,48 @@ class FTPLoader:
 
         self._pycurl = PycURL(connection_parameters=self._connections_parameters)
 
+        # Remote directories seen by any operation, so repeated uploads into the
+        # same hierarchy skip creating it again.
+        self._directories = DirectoryCache()
+
+        # Long-lived file system, only set inside of the context manager.
+        self._ftpfs: FTPFileSystem | None = None
+
+    async def __aenter__(self) -> "FTPLoader":
+        if self._ftpfs is not None:
+            raise RuntimeError("The FTP loader is already open.")
+
+        ftpfs = FTPFileSystem(
+            connection_parameters=self._connections_parameters,
+            executor=self._executor,
+            directories=self._directories,
+        )
+        await ftpfs.__aenter__()
+        self._ftpfs = ftpfs
+
+        return self
+
+    async def __aexit__(self, *args: typing.Any, **kwargs: typing.Any) -> None:
+        ftpfs, self._ftpfs = self._ftpfs, None
+        try:
+            if ftpfs is not None:
+                await ftpfs.__aexit__(*args, **kwargs)
+        finally:
+            self._pycurl.close()
+
+    @contextlib.asynccontextmanager
+    async def _filesystem(self) -> typing.AsyncIterator[FTPFileSystem]:
+        """Provides the long-lived file system or one for a single operation."""
+        if self._ftpfs is not None:
+            yield self._ftpfs
+        else:
+            async with FTPFileSystem(
+                connection_parameters=self._connections_parameters,
+                executor=self._executor,
+                directories=self._directories,
+            ) as ftpfs:
+                yield ftpfs
+
     @property
     def log_interval(self) -> int:
         """Returns the current logging interval for upload progress."""
@@ -75,6 +200,192 @@ class FTPLoader:
 
         self._log_interval = value
 
+    def _stream_workers(self) -> int:
+        """Returns the number of transfers to run next to a directory traversal."""
+        workers = self._connections_parameters.max_workers
+        if self._connections_parameters.backend == "threads":
+            # Leave one thread per connection to the traversal, otherwise the
+            # walk competes with the transfers for the shared executor.
+            workers -= self._connections_parameters.max_connections
+
+        return max(1, workers)
+
+    async def _stream(
+        self,
+        function: typing.Callable[[typing.Any, typing.Any], typing.Any],
+        items: typing.AsyncIterator[tuple[typing.Any, typing.Any]],
+        label: str,
+    ) -> int:
+        """Transfers files while their sources are still being discovered.
+
+        Items flow through a bounded queue, so discovery never runs further ahead
+        of the transfers than the queue allows. Transfers failing with an FTP
+        error are repeated for as many retries as configured and then skipped;
+        the first of them is raised at the end. Any other failure stops the
+        discovery and is raised once every running transfer has finished.
+        """
+        loop = asyncio.get_running_loop()
+
+        queue: asyncio.Queue[tuple[typing.Any, typing.Any] | None] = asyncio.Queue(
+            maxsize=_MAX_PENDING
+        )
+        retries = self._connections_parameters.retries
+        errors: list[Exception] = []
+        failures: list[FTPError] = []
+        count: int = 0
+
+        async def worker() -> None:
+            nonlocal count
+
+            while (item := await queue.get()) is not None:
+                # Keep draining the queue after a failure to never block discovery.
+                if errors:
+                    continue
+
+                for attempt in range(retries + 1):
+                    try:
+                        await loop.run_in_executor(self._executor, function, *item)
+                    except FTPError as err:
+                        if attempt < retries:
+                            logger.warning(
+                                "Transfer from '%s' to '%s' failed, retrying.", *item
+                            )
+                            continue
+
+                        failures.append(err)
+                    except Exception as err:
+                        errors.append(err)
+                    else:
+                        count += 1
+                        if count % self._log_interval == 0:
+                            logger.info("%s: %d", label, count)
+
+                    break
+
+        workers = [asyncio.create_task(worker()) for _ in range(self._stream_workers())]
+        try:
+            async with contextlib.aclosing(items):
+                async for item in items:
+                    if errors:
+                        break
+                    await queue.put(item)
+
+            for _ in workers:
+                await queue.put(None)
+            await asyncio.gather(*workers)
+        finally:
+            for task in workers:
+                task.cancel()
+            await asyncio.gather(*workers, return_exceptions=True)
+
+        if errors:
+            raise errors[0]
+
+        if failures:
+            logger.error("Transfers failed after all retries: %d", len(failures))
+            raise failures[0]
+
+        return count
+
+    async def _walk_remote(
+        self, ftpfs: FTPFileSystem, src: str, dst: str | pathlib.Path
+    ) -> typing.AsyncIterator[tuple[pathlib.Path, str]]:
+        """Yields remote files with their local destinations as they are found."""
+        async for _, _, other in ftpfs.walk(src):
+            for path in other:
+                yield path, os.path.join(dst, os.path.relpath(path, src))
+
+    async def _walk_local(
+        self, ftpfs: FTPFileSystem, src: pathlib.Path, dst: pathlib.Path
+    ) -> typing.AsyncIterator[tuple[pathlib.Path, pathlib.Path]]:
+        """Yields local files with their remote destinations as they are found.
+
+        Remote directories are created just before the first file that needs them.
+        Directories are visited parents first, and the directory cache remembers
+        every created hierarchy, so each one is created at most once.
+        """
+        loop = asyncio.get_running_loop()
+
+        stack = [src]
+        while stack:
+            dirpath = stack.pop()
+            dirs, files = await loop.run_in_executor(
+                self._executor, _scan_local, dirpath
+            )
+            stack.extend(reversed(dirs))
+
+            if not files:
+                continue
+
+            target = dst / dirpath.relative_to(src)
+            if target not in ftpfs.directories:
+                await ftpfs.makedirs(target)
+
+            for path in files:
+                yield path, target / path.name
+
+    async def _download(
+        self,
+        src: list[typing.Any],
+        dst: list[typing.Any],
+        sizes: list[int | None] | None,
+    ) -> None:
+        """Downloads a batch, spreading large files over all connections.
+
+        Files of at least the segment threshold are fetched one at a time in
+        parallel ranges, while all other files share the multi interface in
+        another thread, so both kinds of transfers progress side by side. Both
+        go largest first when the sizes are known.
+        """
+        loop = asyncio.get_running_loop()
+
+        order: typing.Sequence[int] = range(len(src))
+        if sizes is not None:
+            order = _longest_first(sizes)
+
+        threshold = self._connections_parameters.segment_threshold
+        large: dict[int, int] = {}
+        if threshold and sizes is not None:
+            large = {
+                i: size
+                for i in order
+                if (size := sizes[i]) is not None and size >= threshold
+            }
+
+        lock = threading.Lock()
+        index: int = 0
+
+        def progress() -> None:
+            nonlocal index
+            with lock:
+                index += 1
+                if index % self._log_interval == 0:
+                    logger.info("Downloaded: %d / %d", index, len(src))
+
+        def download_large() -> None:
+            for i, size in large.items():
+                self._pycurl.download_segmented(src[i], dst[i], size=size)
+                progress()
+
+        tasks = [
+            # A single thread drives the small files through reused connections.
+            loop.run_in_executor(
+                self._executor,
+                functools.partial(
+                    self._pycurl.download_many,
+                    (src[i] for i in order if i not in large),
+                    (dst[i] for i in order if i not in large),
+                    progress=progress,
+                ),
+            )
+        ]
+        if large:
+            tasks.append(loop.run_in_executor(self._executor, download_large))
+
+        await asyncio.gather(*tasks)
+
+        logger.info("All downloads finished: %d / %d", len(src), len(dst))
+
     @functools.singledispatchmethod
     async def download(
         self,
@@ -107,25 +418,26 @@ class FTPLoader:
                     f"Cannot include directory {str(path)!r} in batch downloads."
                 )
 
-        tasks = [
-            loop.run_in_executor(
-                self._executor, self._pycurl.download, source, destination
+        # Sizes are probed side by side, and files without one are downloaded
+        # in one piece.
+        sizes: list[int | None] | None = None
+        if self._connections_parameters.segment_threshold:
+            sizes = await loop.run_in_executor(
+                self._executor, self._pycurl.size_many, src
             )
-            for source, destination in zip(src, dst, strict=True)
-        ]
-        index: int = 0
-        for future in asyncio.as_completed(tasks):
-            await future
-            index += 1
 
-            if index % self._log_interval == 0:
-                logger.info("Downloaded: %d / %d", index, len(src))
-
-        logger.info("All downloads finished: %d / %d", len(src), len(dst))
+        await self._download(list(src), list(dst), sizes)
 
     @download.register(pathlib.Path)
     @download.register(str)
-    async def _(self, src: str | pathlib.Path, dst: str | pathlib.Path, /) -> None:
+    async def _(
+        self,
+        src: str | pathlib.Path,
+        dst: str | pathlib.Path,
+        /,
+        *,
+        pipeline: bool = False,
+    ) -> None:
         """Downloads files or directories from the remote FTP server.
 
         Parameters
@@ -136,6 +448,10 @@ class FTPLoader:
         dst : str or pathlib.Path, or list of paths
             Local destination path(s).
 
+        pipeline : bool, default=False
+            Starts downloading directory contents while the remote tree is still
+            being traversed instead of collecting every file first.
+
         Raises
         ------
         RuntimeError
@@ -157,23 +473,151 @@ class FTPLoader:
                 raise RuntimeError(f"Cannot download a directory into: {dst!s}")
 
             case (True, True):  # directory to directory
-                async with FTPFileSystem(
-                    connection_parameters=self._connections_parameters,
-                    executor=self._executor,
-                ) as ftpfs:
-                    paths: list[tuple[pathlib.Path, str]] = []
-                    async for _, _, other in ftpfs.walk(src):
-                        for path in other:
-                            dst_path = os.path.join(dst, os.path.relpath(path, src))
-                            paths.append((path, dst_path))
+                async with self._filesystem() as ftpfs:
+                    if pipeline:
+                        count = await self._stream(
+                            self._pycurl.download,
+                            self._walk_remote(ftpfs, src, dst),
+                            "Downloaded",
+                        )
+                        if not count:
+                            logger.warning("No data found to download.")
+                        else:
+                            logger.info("All downloads finished: %d", count)
+
+                        return None
+
+                    paths: list[tuple[pathlib.Path, str, int | None]] = []
+                    async for _, _, other in ftpfs.walk(src, details=True):
+                        for entry in other:
+                            dst_path = os.path.join(
+                                dst, os.path.relpath(entry.path, src)
+                            )
+                            paths.append((entry.path, dst_path, entry.size))
 
                     if not paths:
                         logger.warning("No data found to download.")
 
                         return None
 
-                    src_paths, dst_paths = zip(*paths, strict=True)
-                    await self.download(src_paths, dst_paths)
+                    # Listings already carry the sizes needed to pick large files.
+                    src_paths, dst_paths, sizes = map(list, zip(*paths, strict=True))
+                    await self._download(src_paths, dst_paths, sizes)
+
+    async def sync(
+        self,
+        src: str | pathlib.Path,
+        dst: str | pathlib.Path,
+        /,
+        *,
+        index: str | pathlib.Path,
+        prune: bool = False,
+    ) -> int:
+        """Downloads only the files of a remote directory changed since the last sync.
+
+        Every run records the remote tree in an index with the size and the
+        modification time of each entry, saved as a PathTrie snapshot. A file is
+        fetched again when it is new or its size or modification time differ
+        from the index, or when the local copy is missing or has another size.
+        Files removed from the server are kept locally. The index is only saved
+        once every transfer has succeeded.
+
+        Parameters
+        ----------
+        src : str or pathlib.Path
+            Remote directory to synchronize.
+
+        dst : str or pathlib.Path
+            Local directory that receives the files.
+
+        index : str or pathlib.Path
+            Snapshot file of the index, created on the first run.
+
+        prune : bool, default=False
+            Skip subdirectories whose modification time matches the index along
+            with everything below them. Most servers only update the time of the
+            direct parent of a changed entry, so use this for trees that are
+            written once and never modified in place.
+
+        Returns
+        -------
+        int
+            The number of downloaded files.
+        """
+        loop = asyncio.get_running_loop()
+
+        src = str(src).rstrip("*")
+        index = os.fspath(index)
+
+        previous = PathTrie()
+        if os.path.exists(index):
+            previous = await loop.run_in_executor(self._executor, PathTrie.load, index)
+
+        current = PathTrie()
+        pruned: set[str] = set()
+
+        def is_unchanged(entry: FTPEntry) -> bool:
+            record = previous.metadata(str(entry.path))
+            if record is None or entry.mtime is None:
+                return False
+
+            _, mtime, is_dir = record
+            if not is_dir or mtime != entry.mtime:
+                return False
+
+            pruned.add(str(entry.path))
+
+            return True
+
+        paths: list[tuple[pathlib.Path, str, int | None]] = []
+        count: int = 0
+        async with self._filesystem() as ftpfs:
+            async for _, dirs, files in ftpfs.walk(
+                src, details=True, prune=is_unchanged if prune else None
+            ):
+                for entry in dirs:
+                    current.set_metadata(
+                        str(entry.path),
+                        -1 if entry.size is None else entry.size,
+                        -1 if entry.mtime is None else entry.mtime,
+                        is_dir=True,
+                    )
+
+                targets = [
+                    os.path.join(dst, os.path.relpath(entry.path, src))
+                    for entry in files
+                ]
+                records = [previous.metadata(str(entry.path)) for entry in files]
+
+                # Local files are checked off the event loop, one directory at a time.
+                synced = await loop.run_in_executor(
+                    self._executor,
+                    functools.partial(list, map(_is_synced, files, records, targets)),
+                )
+
+                for entry, target, is_synced in zip(files, targets, synced):
+                    current.set_metadata(
+                        str(entry.path),
+                        -1 if entry.size is None else entry.size,
+                        -1 if entry.mtime is None else entry.mtime,
+                    )
+                    if not is_synced:
+                        paths.append((entry.path, target, entry.size))
+                count += len(files)
+
+        if pruned:
+            await loop.run_in_executor(
+                self._executor, _carry_over, previous, current, pruned
+            )
+
+        logger.info("Files to synchronize: %d / %d", len(paths), count)
+        if paths:
+            src_paths, dst_paths, sizes = map(list, zip(*paths, strict=True))
+            await self._download(src_paths, dst_paths, sizes)
+
+        await loop.run_in_executor(self._executor, current.save, index)
+
+        return len(paths)
 
     @functools.singledispatchmethod
     async def upload(
@@ -229,33 +673,118 @@ class FTPLoader:
                     f"Upload failed due to invalid destination path: {path!s}"
                 )
 
-        async with FTPFileSystem(
-            connection_parameters=self._connections_parameters,
-            executor=self._executor,
-        ) as ftpfs:
+        async with self._filesystem() as ftpfs:
             # Tests indicate that building the directory hierarchy before upload leads
             # to better performance in concurrent transfer scenarios.
             await ftpfs.makedirs({pathlib.Path(path).parent for path in dst})
 
-        tasks = [
-            loop.run_in_executor(
-                self._executor, self._pycurl.upload, source, destination
-            )
-            for source, destination in zip(sources, dst, strict=True)
-        ]
         index: int = 0
-        for future in asyncio.as_completed(tasks):
-            await future
+
+        def progress() -> None:
+            nonlocal index
             index += 1
 
             if index % self._log_interval == 0:
                 logger.info("Uploaded: %d / %d", index, len(sources))
 
+        # Largest files go first, so none of them is left running alone at the end.
+        order = await loop.run_in_executor(
+            self._executor,
+            lambda: _longest_first([_local_size(path) for path in sources]),
+        )
+
+        # A single thread drives the whole batch through reused connections.
+        await loop.run_in_executor(
+            self._executor,
+            functools.partial(
+                self._pycurl.upload_many,
+                [sources[i] for i in order],
+                [dst[i] for i in order],
+                progress=progress,
+            ),
+        )
+
         logger.info("All uploads finished: %d / %d", len(sources), len(dst))
 
+    async def _upload_packed(self, src: pathlib.Path, dst: pathlib.Path) -> None:
+        """Uploads a directory with its small files packed into archive segments.
+
+        Large files are uploaded as they are through the multi interface, while
+        the segments are built and sent side by side with them. The manifest goes
+        last, so its arrival tells the server that every segment is complete.
+        """
+        loop = asyncio.get_running_loop()
+
+        members = await loop.run_in_executor(self._executor, _packing.collect, src)
+        if not members:
+            logger.warning("No data to upload.")
+
+            return None
+
+        small = [item for item in members if item.size < _packing.PACK_THRESHOLD]
+        large = [item for item in members if item.size >= _packing.PACK_THRESHOLD]
+        segments = await loop.run_in_executor(self._executor, _packing.pack, small)
+
+        async with self._filesystem() as ftpfs:
+            await ftpfs.makedirs({dst} | {(dst / item.name).parent for item in large})
+
+        logger.info("Packed %d files into %d archives.", len(small), len(segments))
+
+        def upload_segment(segment: _packing.TarStream, path: pathlib.Path) -> None:
+            # Every attempt sends the archive from its very beginning.
+            segment.rewind()
+            self._pycurl.upload_stream(segment, path, segment.size)
+
+        async def items() -> typing.AsyncIterator[tuple[typing.Any, pathlib.Path]]:
+            for index, segment in enumerate(segments):
+                yield segment, dst / _packing.segment_name(index)
+
+        tasks = [self._stream(upload_segment, items(), "Uploaded archives")]
+        if large:
+            tasks.append(
+                loop.run_in_executor(
+                    self._executor,
+                    functools.partial(
+                        self._pycurl.upload_many,
+                        [item.path for item in large],
+                        [dst / item.name for item in large],
+                    ),
+                )
+            )
+
+        await asyncio.gather(*tasks)
+
+        if segments:
+            manifest = await loop.run_in_executor(
+                self._executor, _packing.manifest, segments
+            )
+
+            fd, path = tempfile.mkstemp(suffix=".trie")
+            os.close(fd)
+            try:
+                await loop.run_in_executor(self._executor, manifest.save, path)
+                await loop.run_in_executor(
+                    self._executor,
+                    self._pycurl.upload,
+                    path,
+                    dst / _packing.MANIFEST_NAME,
+                )
+            finally:
+                os.remove(path)
+
+        logger.info("All uploads finished: %d", len(members))
+
     @upload.register(pathlib.Path)
     @upload.register(str)
-    async def _(self, src: str | pathlib.Path, dst: str | pathlib.Path, /) -> None:
+    async def _(
+        self,
+        src: str | pathlib.Path,
+        dst: str | pathlib.Path,
+        /,
+        *,
+        pipeline: bool = False,
+        pack: bool = False,
+    ) -> None:
         """Uploads single or multiple files and directories asynchronously.
 
         Parameters
@@ -266,12 +795,29 @@ class FTPLoader:
         dst : str or pathlib.Path, or list of paths
             Destination path(s).
 
+        pipeline : bool, default=False
+            Starts uploading directory contents while the local tree is still being
+            traversed, creating remote directories just ahead of their files.
+
+        pack : bool, default=False
+            Sends the files of a directory below 16 KB as tar archives of up to
+            64 MB built during the upload, for servers that unpack them with a
+            hook. The archives are named ``.pyftpkit-pack-NNNNN.tar`` and followed
+            by ``.pyftpkit-pack.trie``, a PathTrie snapshot listing the files of
+            every archive with their size and modification time.
+
         Raises
         ------
         RuntimeError
             Upload failed because there are no files, a destination is a directory, or
             a directory was mapped to a file
+
+        ValueError
+            If both pipelined and packed uploads are requested.
         """
+        if pipeline and pack:
+            raise ValueError("Packed uploads cannot be pipelined.")
+
         src = str(src).rstrip("*")
 
         match (os.path.isfile(src), os.path.isdir(src), _is_dirpath(dst)):
@@ -289,5 +835,21 @@ class FTPLoader:
                     f"\nDestination: {dst!s}"
                 )
 
+            case (_, True, True) if pack:  # directory to directory, packed
+                await self._upload_packed(pathlib.Path(src), pathlib.Path(dst))
+
+            case (_, True, True) if pipeline:  # directory to directory, streamed
+                async with self._filesystem() as ftpfs:
+                    count = await self._stream(
+                        self._pycurl.upload,
+                        self._walk_local(ftpfs, pathlib.Path(src), pathlib.Path(dst)),
+                        "Uploaded",
+                    )
+
+                if not count:
+                    logger.warning("No data to upload.")
+                else:
+                    logger.info("All uploads finished: %d", count)
+
             case (_, True, True):  # directory to directory
                 await self.upload([src], dst)
@@ -14,6 +14,8 @@ class FTPLoader:
     def __init__(
         self, connections_parameters: ConnectionParameters, *, log_interval: int = ...
     ) -> None: ...
+    async def __aenter__(self) -> FTPLoader: ...
+    async def __aexit__(self, *args: typing.Any, **kwargs: typing.Any) -> None: ...
     @property
     def log_interval(self) -> int: ...
     @log_interval.setter
@@ -27,8 +29,22 @@ class FTPLoader:
     ) -> None: ...
     @typing.overload
     async def download(
-        self, src: str | pathlib.Path, dst: str | pathlib.Path, /
+        self,
+        src: str | pathlib.Path,
+        dst: str | pathlib.Path,
+        /,
+        *,
+        pipeline: bool = False,
     ) -> None: ...
+    async def sync(
+        self,
+        src: str | pathlib.Path,
+        dst: str | pathlib.Path,
+        /,
+        *,
+        index: str | pathlib.Path,
+        prune: bool = False,
+    ) -> int: ...
     @typing.overload
     async def upload(
         self,
@@ -38,5 +54,11 @@ class FTPLoader:
     ) -> None: ...
     @typing.overload
     async def upload(
-        self, src: str | pathlib.Path, dst: str | pathlib.Path, /
+        self,
+        src: str | pathlib.Path,
+        dst: str | pathlib.Path,
+        /,
+        *,
+        pipeline: bool = False,
+        pack: bool = False,
     ) -> None: ...
@@ -0,0 +1,150 @@
+# -*- coding: utf-8 -*-
+
+# Copyright 2025 (c) Vladislav Punko <iam.vlad.punko@gmail.com>
+
+"""Counters, histograms and gauges of the hot paths.
+
+Nothing is recorded until a sink is installed with set_sink, so the cost of an
+instrumentation point without a sink is a single attribute check. A sink
+receives every measurement as it happens and is free to forward it to
+Prometheus, OpenTelemetry or any other backend. Measurements arrive from worker
+threads as well as from the event loop, so sinks must be thread-safe.
+
+Recorded metrics:
+
+- pool_wait_seconds: time spent waiting for a pooled connection.
+- pool_acquired_total: connections handed out, each one a reused session.
+- pool_connections_opened_total: control connections opened by the pool.
+- pool_connections_evicted_total: dead connections dropped by the pool.
+- ftp_command_seconds{command}: round trip of every control command.
+- listing_parse_seconds: time spent parsing one directory listing.
+- listing_entries: number of entries in one directory listing.
+- transfer_bytes_total{direction}: bytes moved by cURL transfers.
+- transfer_bytes_per_second{direction}: average rate of one transfer.
+- transfer_connects_total{direction}: connections cURL had to open.
+- walk_queue_depth: directories waiting to be listed by walk.
+- walk_output_queue_depth: listed directories waiting for the consumer.
+"""
+
+import threading
+import typing
+
+__all__ = [
+    "InMemorySink",
+    "MetricsSink",
+    "enabled",
+    "gauge",
+    "get_sink",
+    "increment",
+    "observe",
+    "set_sink",
+]
+
+Labels: typing.TypeAlias = typing.Mapping[str, str]
+
+
+class MetricsSink(typing.Protocol):
+    """Receives measurements from the instrumentation points."""
+
+    def increment(self, name: str, value: float, labels: Labels) -> None:
+        """Adds a value to a monotonically increasing counter."""
+
+    def observe(self, name: str, value: float, labels: Labels) -> None:
+        """Records a sample of a histogram such as a duration or a size."""
+
+    def gauge(self, name: str, value: float, labels: Labels) -> None:
+        """Sets the current value of a quantity that goes up and down."""
+
+
+class _Summary(typing.NamedTuple):
+    count: int
+    total: float
+    min: float
+    max: float
+
+
+class InMemorySink:
+    """Aggregates measurements in memory.
+
+    Histograms are kept as count, sum, minimum and maximum and gauges as their
+    last value, so the memory footprint does not grow with the number of samples.
+    Useful for tests and for ad hoc inspection of a single run.
+    """
+
+    def __init__(self) -> None:
+        self._lock = threading.Lock()
+
+        self.counters: dict[tuple[str, tuple[tuple[str, str], ...]], float] = {}
+        self.histograms: dict[tuple[str, tuple[tuple[str, str], ...]], _Summary] = {}
+        self.gauges: dict[tuple[str, tuple[tuple[str, str], ...]], float] = {}
+
+    def increment(self, name: str, value: float, labels: Labels) -> None:
+        key = (name, tuple(sorted(labels.items())))
+        with self._lock:
+            self.counters[key] = self.counters.get(key, 0) + value
+
+    def observe(self, name: str, value: float, labels: Labels) -> None:
+        key = (name, tuple(sorted(labels.items())))
+        with self._lock:
+            summary = self.histograms.get(key)
+            if summary is None:
+                self.histograms[key] = _Summary(1, value, value, value)
+            else:
+                self.histograms[key] = _Summary(
+                    summary.count + 1,
+                    summary.total + value,
+                    min(summary.min, value),
+                    max(summary.max, value),
+                )
+
+    def gauge(self, name: str, value: float, labels: Labels) -> None:
+        key = (name, tuple(sorted(labels.items())))
+        with self._lock:
+            self.gauges[key] = value
+
+    def counter(self, name: str, **labels: str) -> float:
+        """Returns the value of a counter, zero if it was never incremented."""
+        with self._lock:
+            return self.counters.get((name, tuple(sorted(labels.items()))), 0)
+
+    def histogram(self, name: str, **labels: str) -> _Summary | None:
+        """Returns the summary of a histogram if it has any samples."""
+        with self._lock:
+            return self.histograms.get((name, tuple(sorted(labels.items()))))
+
+
+_sink: MetricsSink | None = None
+
+
+def set_sink(sink: MetricsSink | None) -> None:
+    """Installs the sink for all measurements, None turns recording off."""
+    global _sink
+    _sink = sink
+
+
+def get_sink() -> MetricsSink | None:
+    """Returns the installed sink if there is one."""
+    return _sink
+
+
+def enabled() -> bool:
+    """Checks whether measurements are recorded, to skip expensive probes."""
+    return _sink is not None
+
+
+def increment(name: str, value: float = 1, **labels: str) -> None:
+    """Adds a value to a counter of the installed sink."""
+    if _sink is not None:
+        _sink.increment(name, value, labels)
+
+
+def observe(name: str, value: float, **labels: str) -> None:
+    """Records a histogram sample with the installed sink."""
+    if _sink is not None:
+        _sink.observe(name, value, labels)
+
+
+def gauge(name: str, value: float, **labels: str) -> None:
+    """Sets a gauge of the installed sink."""
+    if _sink is not None:
+        _sink.gauge(name, value, labels)
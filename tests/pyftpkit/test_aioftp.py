@@ -0,0 +1,93 @@
+# -*- coding: utf-8 -*-
+
+# Copyright 2025 (c) Vladislav Punko <iam.vlad.punko@gmail.com>
+
+import ftplib
+
+import pytest
+import pytest_asyncio
+
+from pyftpkit._aioftp import AsyncFTP
+
+
+@pytest_asyncio.fixture
+async def ftp(ftp_server, username, password):
+    ftp = AsyncFTP()
+    await ftp.connect(ftp_server.host, ftp_server.port, timeout=2)
+    await ftp.login(username, password)
+
+    yield ftp
+
+    await ftp.close()
+
+
+@pytest.mark.asyncio
+async def test_connect(ftp_server, username, password):
+    ftp = AsyncFTP()
+
+    welcome = await ftp.connect(ftp_server.host, ftp_server.port, timeout=2)
+    assert welcome.startswith("220")
+
+    response = await ftp.login(username, password)
+    assert response.startswith("230")
+
+    response = await ftp.quit()
+    assert response.startswith("221")
+
+
+@pytest.mark.asyncio
+async def test_login_with_error(ftp_server):
+    ftp = AsyncFTP()
+    await ftp.connect(ftp_server.host, ftp_server.port, timeout=2)
+
+    with pytest.raises(ftplib.error_perm):
+        await ftp.login("unknown", "unknown")
+
+    await ftp.close()
+
+
+@pytest.mark.asyncio
+async def test_directories(ftp, ftp_server):
+    await ftp.mkd("/dir")
+    assert (ftp_server.home / "dir").is_dir()
+
+    await ftp.cwd("/dir")
+
+    await ftp.rmd("/dir")
+    assert not (ftp_server.home / "dir").exists()
+
+    with pytest.raises(ftplib.error_perm):
+        await ftp.cwd("/dir")
+
+
+@pytest.mark.asyncio
+async def test_retrbinary(ftp, ftp_server):
+    (ftp_server.home / "text.txt").write_bytes(b"x" * 100_000)
+
+    chunks = []
+    response = await ftp.retrbinary("RETR /text.txt", chunks.append)
+
+    assert response.startswith("226")
+    assert b"".join(chunks) == b"x" * 100_000
+
+    chunks = []
+    await ftp.retrbinary("MLSD /", chunks.append)
+
+    assert b"text.txt" in b"".join(chunks)
+
+
+@pytest.mark.asyncio
+async def test_delete(ftp, ftp_server):
+    (ftp_server.home / "text.txt").write_text("")
+
+    await ftp.delete("/text.txt")
+    assert not (ftp_server.home / "text.txt").exists()
+
+    with pytest.raises(ftplib.error_perm):
+        await ftp.delete("/text.txt")
+
+
+@pytest.mark.asyncio
+async def test_supports(ftp):
+    assert await ftp.supports("MLST")
+    assert not await ftp.supports("UNKNOWN")
@@ -2,6 +2,7 @@
 
 # Copyright 2025 (c) Vladislav Punko <iam.vlad.punko@gmail.com>
 
+import ftplib
 import socket
 import struct
 from unittest import mock
@@ -27,3 +28,22 @@ def test_connect_sets_socket_options(host, port):
             mock.call(socket.SOL_SOCKET, socket.SO_LINGER, struct.pack("ii", 1, 0)),
         ]
         socket_mock.setsockopt.assert_has_calls(expected_calls, any_order=False)
+
+
+def test_supports():
+    ftp = FTP()
+
+    reply = "211-Features:\n MLST type*;size*;modify*;\n UTF8\n211 End"
+    with mock.patch.object(ftp, "sendcmd", return_value=reply) as sendcmd_mock:
+        assert ftp.supports("mlst")
+        assert ftp.supports("UTF8")
+        assert not ftp.supports("REST")
+
+    sendcmd_mock.assert_called_once_with("FEAT")
+
+
+def test_supports_without_feat():
+    ftp = FTP()
+
+    with mock.patch.object(ftp, "sendcmd", side_effect=ftplib.error_perm("500")):
+        assert not ftp.supports("MLST")
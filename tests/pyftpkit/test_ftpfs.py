@@ -12,9 +12,10 @@ import uuid
 
 import pytest
 
+from pyftpkit import metrics
 from pyftpkit.connection_parameters import ConnectionParameters
 from pyftpkit.exceptions import FTPError
-from pyftpkit.ftpfs import FTPFileSystem
+from pyftpkit.ftpfs import DirectoryCache, FTPFileSystem
 
 
 @pytest.fixture
@@ -117,6 +118,23 @@ async def test_listdir_with_error(
     assert message in str(err.value)
 
 
+@pytest.mark.asyncio
+async def test_listdir_without_cwd(
+    fs_no_root, mocker, ftp_server, connection_parameters
+):
+    (ftp_server.home / "dir").mkdir()
+
+    cwd_mock = mocker.patch("pyftpkit.ftpfs.FTP.cwd")
+
+    async with FTPFileSystem(connection_parameters=connection_parameters) as ftpfs:
+        dirs, nondirs = await ftpfs.listdir(ftp_server.root)
+
+    assert dirs == [ftp_server.root / "dir"]
+    assert nondirs == []
+
+    cwd_mock.assert_not_called()
+
+
 @pytest.mark.asyncio
 async def test_listdir_bad_entry(fs_no_root, mocker, ftp_server, connection_parameters):
     entries = [
@@ -128,8 +146,12 @@ async def test_listdir_bad_entry(fs_no_root, mocker, ftp_server, connection_para
         "drwxr-xr-x   2 owner group        4096 Oct 27 09:20 .",
         "drwxr-xr-x   2 owner group        4096 Oct 27 09:21 ..",
     ]
-    retrlines_mock = mocker.patch("pyftpkit.ftpfs.FTP.retrlines")
-    retrlines_mock.side_effect = lambda _, callback: list(map(callback, entries))
+    mocker.patch("pyftpkit.ftpfs.FTP.supports", return_value=False)
+
+    retrbinary_mock = mocker.patch("pyftpkit.ftpfs.FTP.retrbinary")
+    retrbinary_mock.side_effect = lambda _, callback: callback(
+        "\r\n".join(entries).encode()
+    )
 
     async with FTPFileSystem(connection_parameters=connection_parameters) as ftpfs:
         dirs, nondirs = await ftpfs.listdir(ftp_server.root)
@@ -163,6 +185,67 @@ async def test_walk(fs_no_root, ftp_server, dirtree, connection_parameters):
     assert set(collected_nondirs) == set(dirtree.ftp_nondirs)
 
 
+@pytest.mark.asyncio
+async def test_scandir(fs_no_root, ftp_server, connection_parameters):
+    (ftp_server.home / "dir").mkdir()
+    (ftp_server.home / "text.txt").write_text("12345")
+
+    async with FTPFileSystem(connection_parameters=connection_parameters) as ftpfs:
+        dirs, nondirs = await ftpfs.scandir(ftp_server.root)
+
+    assert [(entry.path, entry.type) for entry in dirs] == [
+        (ftp_server.root / "dir", "dir"),
+    ]
+    assert [(entry.path, entry.type, entry.size) for entry in nondirs] == [
+        (ftp_server.root / "text.txt", "file", 5),
+    ]
+    assert nondirs[0].mtime == int((ftp_server.home / "text.txt").stat().st_mtime)
+
+
+@pytest.mark.asyncio
+async def test_walk_details(fs_no_root, ftp_server, dirtree, connection_parameters):
+    collected_dirs = []
+    collected_nondirs = []
+
+    async with FTPFileSystem(connection_parameters=connection_parameters) as ftpfs:
+        async for _, dirs, nondirs in ftpfs.walk(ftp_server.root, details=True):
+            collected_dirs.extend(entry.path for entry in dirs)
+            collected_nondirs.extend(entry.path for entry in nondirs)
+
+            assert all(entry.type == "dir" for entry in dirs)
+            assert all(entry.size is not None for entry in nondirs)
+
+    assert set(collected_dirs) == set(dirtree.ftp_dirs)
+    assert set(collected_nondirs) == set(dirtree.ftp_nondirs)
+
+
+@pytest.mark.asyncio
+async def test_walk_prune(fs_no_root, ftp_server, connection_parameters):
+    (ftp_server.home / "1" / "2").mkdir(parents=True)
+    (ftp_server.home / "3").mkdir()
+    (ftp_server.home / "3" / "3.txt").write_text("")
+
+    walked = []
+    async with FTPFileSystem(connection_parameters=connection_parameters) as ftpfs:
+        with pytest.raises(ValueError):
+            async for _ in ftpfs.walk(ftp_server.root, prune=lambda entry: True):
+                pass
+
+        async for dirpath, dirs, _ in ftpfs.walk(
+            ftp_server.root, details=True, prune=lambda entry: entry.path.name == "1"
+        ):
+            walked.append(dirpath)
+
+            # Pruned directories are still reported by their parent.
+            if dirpath == pathlib.Path(ftp_server.root):
+                assert {entry.path.name for entry in dirs} == {"1", "3"}
+
+    assert set(walked) == {
+        pathlib.Path(ftp_server.root),
+        pathlib.Path(ftp_server.root) / "3",
+    }
+
+
 @pytest.mark.asyncio
 async def test_walk_no_permission(
     fs_no_root, caplog, ftp_server, dirtree, connection_parameters
@@ -182,6 +265,30 @@ async def test_walk_no_permission(
     assert message in str(err.value)
 
 
+@pytest.mark.asyncio
+async def test_walk_connect_error(
+    fs_no_root, mocker, ftp_server, dirtree, connection_parameters
+):
+    connection_parameters.min_connections = 0
+
+    async with FTPFileSystem(connection_parameters=connection_parameters) as ftpfs:
+        mocker.patch(
+            "pyftpkit._pool.FTPPoolExecutor._connect",
+            side_effect=FTPError("Could not open an FTP connection."),
+        )
+
+        async def consume():
+            async for _, _, _ in ftpfs.walk(ftp_server.root):
+                pass
+
+        # Workers that cannot get a connection end the walk instead of leaving
+        # it waiting for output.
+        with pytest.raises(RuntimeError) as err:
+            await asyncio.wait_for(consume(), timeout=5)
+
+    assert isinstance(err.value.__cause__, FTPError)
+
+
 @pytest.mark.asyncio
 async def test_walk_drain_output_queue(
     fs_no_root, mocker, ftp_server, connection_parameters
@@ -197,16 +304,16 @@ async def test_walk_drain_output_queue(
         [pathlib.Path(ftp_server.root) / "test" / "text.txt"],
     )
 
-    original_listdir = FTPFileSystem._listdir
+    original_list = FTPFileSystem._list
 
-    async def listdir(self, path, ftp):
-        if path.name == "test":
+    async def list_(self, paths, ftp):
+        if any(path.name == "test" for path in paths):
             await asyncio.sleep(random.uniform(0.1, 0.5))  # short delay
-        return await original_listdir(self, path, ftp)
+        return await original_list(self, paths, ftp)
 
     mocker.patch(
-        "pyftpkit.ftpfs.FTPFileSystem._listdir",
-        new=listdir,
+        "pyftpkit.ftpfs.FTPFileSystem._list",
+        new=list_,
     )
 
     output = []
@@ -225,6 +332,35 @@ async def test_walk_drain_output_queue(
     assert drained_item == expected_output
 
 
+@pytest.mark.asyncio
+@pytest.mark.parametrize("max_pending", [1, 3])
+async def test_walk_max_pending(
+    fs_no_root, ftp_server, dirtree, connection_parameters, max_pending
+):
+    collected_dirs = []
+    collected_nondirs = []
+
+    async with FTPFileSystem(connection_parameters=connection_parameters) as ftpfs:
+        async for _, dirs, nondirs in ftpfs.walk(
+            ftp_server.root, max_pending=max_pending
+        ):
+            await asyncio.sleep(0.01)  # slow consumer
+
+            collected_dirs.extend(dirs)
+            collected_nondirs.extend(nondirs)
+
+    assert sorted(collected_dirs) == sorted(dirtree.ftp_dirs)
+    assert sorted(collected_nondirs) == sorted(dirtree.ftp_nondirs)
+
+
+@pytest.mark.asyncio
+async def test_walk_invalid_max_pending(fs_no_root, connection_parameters):
+    async with FTPFileSystem(connection_parameters=connection_parameters) as ftpfs:
+        with pytest.raises(ValueError):
+            async for _ in ftpfs.walk("/", max_pending=0):
+                pass
+
+
 @pytest.mark.asyncio
 async def test_makedirs(fs_no_root, caplog, ftp_server, connection_parameters):
     async with FTPFileSystem(connection_parameters=connection_parameters) as ftpfs:
@@ -259,6 +395,18 @@ async def test_makedirs(fs_no_root, caplog, ftp_server, connection_parameters):
         assert path.exists() and path.is_dir()
 
 
+@pytest.mark.asyncio
+async def test_makedirs_levels(fs_no_root, ftp_server, connection_parameters):
+    paths = [f"/wide/{index}/{index}" for index in range(20)]
+
+    async with FTPFileSystem(connection_parameters=connection_parameters) as ftpfs:
+        await ftpfs.makedirs(paths)
+
+    for path in paths:
+        path = ftp_server.home / path.lstrip("/")
+        assert path.is_dir() and path.parent.is_dir()
+
+
 @pytest.mark.asyncio
 async def test_makedirs_no_permission(fs_no_root, caplog, ftp_server):
     path = "/test"
@@ -286,6 +434,60 @@ async def test_makedirs_no_permission(fs_no_root, caplog, ftp_server):
     assert message in str(err.value)
 
 
+@pytest.mark.asyncio
+async def test_makedirs_cache(fs_no_root, ftp_server, connection_parameters):
+    sink = metrics.InMemorySink()
+    metrics.set_sink(sink)
+
+    def count(command):
+        summary = sink.histogram("ftp_command_seconds", command=command)
+        return 0 if summary is None else summary.count
+
+    directories = DirectoryCache()
+    try:
+        async with FTPFileSystem(
+            connection_parameters=connection_parameters, directories=directories
+        ) as ftpfs:
+            await ftpfs.makedirs(["/1/2/3", "/4"])
+
+        # Directories below a new one are created without probing for them.
+        assert count("CWD") == 2
+        assert count("MKD") == 4
+        assert "/1/2" in directories
+
+        async with FTPFileSystem(
+            connection_parameters=connection_parameters, directories=directories
+        ) as ftpfs:
+            await ftpfs.makedirs(["/1/2", "/4"])
+
+            assert count("CWD") == 2
+            assert count("MKD") == 4
+
+            await ftpfs.rmtree("/1")
+
+            assert "/1" not in directories
+            assert "/1/2" not in directories
+            assert "/4" in directories
+
+            await ftpfs.makedirs("/1/2")
+
+        assert count("MKD") == 6
+        assert (ftp_server.home / "1" / "2").is_dir()
+    finally:
+        metrics.set_sink(None)
+
+
+@pytest.mark.asyncio
+async def test_listdir_cache(fs_no_root, ftp_server, connection_parameters):
+    (ftp_server.home / "1" / "2").mkdir(parents=True)
+
+    async with FTPFileSystem(connection_parameters=connection_parameters) as ftpfs:
+        await ftpfs.listdir("/1/2")
+
+        assert "/1/2" in ftpfs.directories
+        assert "/1/3" not in ftpfs.directories
+
+
 @pytest.mark.asyncio
 async def test_rm(fs_no_root, caplog, ftp_server, connection_parameters):
     path = ftp_server.home / "text.txt"
@@ -329,10 +531,9 @@ async def test_rmtree(fs_no_root, caplog, ftp_server, dirtree, connection_parame
         with caplog.at_level(logging.DEBUG, logger="pyftpkit"):
             await ftpfs.rmtree(path)
 
-    message = f"Deleting {len(dirtree.ftp_nondirs)} files from the FTP server..."
-    assert message in caplog.text
-
-    message = f"Deleting {len(dirtree.ftp_dirs)+1} directories..."
+    message = "Deleted {0:d} files and {1:d} directories.".format(
+        len(dirtree.ftp_nondirs), len(dirtree.ftp_dirs)
+    )
     assert message in caplog.text
 
     for dirpath in dirtree.ftp_dirs:
@@ -345,6 +546,42 @@ async def test_rmtree(fs_no_root, caplog, ftp_server, dirtree, connection_parame
     assert not list(ftp_server.home.iterdir())
 
 
+@pytest.mark.asyncio
+async def test_rmtree_subdirectory(fs_no_root, ftp_server, connection_parameters):
+    path = ftp_server.home / "1" / "2" / "3"
+    path.mkdir(parents=True)
+    (path / "text.txt").write_text("")
+    (ftp_server.home / "1" / "text.txt").write_text("")
+
+    path = ftp_server.home / "4"
+    path.mkdir()
+    (path / "text.txt").write_text("")
+
+    async with FTPFileSystem(connection_parameters=connection_parameters) as ftpfs:
+        await ftpfs.rmtree(ftp_server.root / "1")
+
+    assert [path.name for path in ftp_server.home.iterdir()] == ["4"]
+    assert (path / "text.txt").is_file()
+
+
+@pytest.mark.asyncio
+async def test_rmtree_connect_error(
+    fs_no_root, mocker, ftp_server, dirtree, connection_parameters
+):
+    connection_parameters.min_connections = 0
+
+    async with FTPFileSystem(connection_parameters=connection_parameters) as ftpfs:
+        mocker.patch(
+            "pyftpkit._pool.FTPPoolExecutor._connect",
+            side_effect=FTPError("Could not open an FTP connection."),
+        )
+
+        with pytest.raises(FTPError):
+            await asyncio.wait_for(ftpfs.rmtree(ftp_server.root), timeout=5)
+
+    assert all(dirpath.is_dir() for dirpath in dirtree.dirs)
+
+
 @pytest.mark.asyncio
 async def test_rmtree_no_permission(fs_no_root, caplog, ftp_server):
     path = ftp_server.home / "test"
@@ -373,3 +610,29 @@ async def test_rmtree_no_permission(fs_no_root, caplog, ftp_server):
 
     message = f"Failed to remove directory {str(ftp_path)!r} from the FTP server."
     assert message in str(err.value)
+
+
+@pytest.mark.asyncio
+async def test_asyncio_backend(fs_no_root, ftp_server, dirtree, connection_parameters):
+    connection_parameters.backend = "asyncio"
+
+    async with FTPFileSystem(connection_parameters=connection_parameters) as ftpfs:
+        collected_dirs = []
+        collected_nondirs = []
+        async for _, dirs, nondirs in ftpfs.walk(ftp_server.root):
+            collected_dirs.extend(dirs)
+            collected_nondirs.extend(nondirs)
+
+        assert set(collected_dirs) == set(dirtree.ftp_dirs)
+        assert set(collected_nondirs) == set(dirtree.ftp_nondirs)
+
+        await ftpfs.makedirs(["/new/1", "/new/2"])
+        assert (ftp_server.home / "new" / "1").is_dir()
+        assert (ftp_server.home / "new" / "2").is_dir()
+
+        await ftpfs.rm(dirtree.ftp_nondirs[0])
+        assert not dirtree.nondirs[0].exists()
+
+        await ftpfs.rmtree(ftp_server.root)
+
+    assert not list(ftp_server.home.iterdir())
@@ -0,0 +1,88 @@
+# -*- coding: utf-8 -*-
+
+# Copyright 2025 (c) Vladislav Punko <iam.vlad.punko@gmail.com>
+
+import calendar
+
+import pytest
+
+from pyftpkit._listing import parse_listing
+
+
+def _timestamp(*args):
+    return calendar.timegm((*args, 0, 0, 0))
+
+
+def test_parse_listing_unix():
+    buffer = (
+        b"total 12\r\n"
+        b"drwxr-xr-x   2 owner group        4096 Oct 27  2023 dir\r\n"
+        b"-rw-r--r--   1 owner group         512 Jan  2  2020 name  with   spaces\r\n"
+        b"lrwxrwxrwx   1 owner group          11 Mar  3  2021 symlink -> text.txt\r\n"
+        b"-rw-r--r--   1 jan   12           2020 Oct 27  2022 tricky\r\n"
+        b"drwxr-xr-x   2 owner group        4096 Oct 27  2023 .\r\n"
+        b"drwxr-xr-x   2 owner group        4096 Oct 27  2023 ..\r\n"
+        b"error\r\n"
+    )
+    listing = parse_listing(buffer)
+
+    assert len(listing) == 4
+    assert listing.names == ["dir", "name  with   spaces", "symlink", "tricky"]
+    assert listing.types == b"dflf"
+    assert listing.sizes == [4096, 512, 11, 2020]
+    assert listing.mtimes == [
+        _timestamp(2023, 10, 27, 0, 0, 0),
+        _timestamp(2020, 1, 2, 0, 0, 0),
+        _timestamp(2021, 3, 3, 0, 0, 0),
+        _timestamp(2022, 10, 27, 0, 0, 0),
+    ]
+
+
+def test_parse_listing_unix_recent():
+    listing = parse_listing(b"-rw-r--r-- 1 owner group 1 Jan 01 12:30 recent\n")
+
+    assert listing.names == ["recent"]
+    assert listing.mtimes[0] % 86400 == 12 * 3600 + 30 * 60
+
+
+def test_parse_listing_mlsd():
+    buffer = (
+        b"type=cdir;modify=20231027091500; .\r\n"
+        b"type=pdir;modify=20231027091500; ..\r\n"
+        b"type=dir;modify=20231027091500; dir\r\n"
+        b"Type=file;Size=512;Modify=20231027091500.250; name  with spaces\r\n"
+        b"type=OS.unix=slink:/target;modify=20231027091500; symlink\r\n"
+    )
+    listing = parse_listing(buffer, format="mlsd")
+
+    assert listing.names == ["dir", "name  with spaces", "symlink"]
+    assert listing.types == b"dfl"
+    assert listing.sizes == [-1, 512, -1]
+    assert listing.mtimes == [_timestamp(2023, 10, 27, 9, 15, 0)] * 3
+
+
+def test_parse_listing_dos():
+    buffer = (
+        b"10-27-23  09:12PM       <DIR>          dir\r\n"
+        b"10-27-2023  12:05AM                 512 text file.txt\r\n"
+    )
+    listing = parse_listing(buffer)
+
+    assert listing.names == ["dir", "text file.txt"]
+    assert listing.types == b"df"
+    assert listing.sizes == [-1, 512]
+    assert listing.mtimes == [
+        _timestamp(2023, 10, 27, 21, 12, 0),
+        _timestamp(2023, 10, 27, 0, 5, 0),
+    ]
+
+
+def test_parse_listing_encoding():
+    listing = parse_listing(b"type=file; caf\xc3\xa9\r\ntype=file; \xff\r\n")
+
+    assert listing.names == ["café", "\udcff"]
+
+
+def test_parse_listing_invalid_format():
+    with pytest.raises(ValueError):
+        parse_listing(b"", format="vms")
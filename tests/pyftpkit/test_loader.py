@@ -5,12 +5,15 @@
 import logging
 import os
 import pathlib
+import tarfile
 
 import pycurl
 import pytest
 
+from pyftpkit import metrics
+from pyftpkit._pathtrie import PathTrie
 from pyftpkit.connection_parameters import ConnectionParameters
-from pyftpkit.loader import FTPLoader, _is_dirpath
+from pyftpkit.loader import FTPLoader, _is_dirpath, _longest_first
 
 
 @pytest.fixture
@@ -52,6 +55,19 @@ def test_is_dirpath(path, is_dirpath):
     assert _is_dirpath(path) is is_dirpath
 
 
+@pytest.mark.parametrize(
+    "sizes, order",
+    [
+        ([], []),
+        ([1, 30, 2], [1, 2, 0]),
+        ([1, None, 30, None, 2], [2, 4, 0, 1, 3]),
+        ([5, 5, 5], [0, 1, 2]),
+    ],
+)
+def test_longest_first(sizes, order):
+    assert _longest_first(sizes) == order
+
+
 def test_set_log_interval_with_error(connection_parameters):
     loader = FTPLoader(connections_parameters=connection_parameters)
 
@@ -70,6 +86,32 @@ def test_set_log_interval(connection_parameters):
     assert loader.log_interval == log_interval
 
 
+@pytest.mark.asyncio
+async def test_context_manager(tmp_path, ftp_server, connection_parameters):
+    src = tmp_path / "src"
+    (src / "1").mkdir(parents=True)
+    (src / "1" / "1.txt").write_text("1")
+    (src / "2.txt").write_text("2")
+
+    sink = metrics.InMemorySink()
+    metrics.set_sink(sink)
+    try:
+        async with FTPLoader(connections_parameters=connection_parameters) as loader:
+            await loader.upload(src, "/data")
+            await loader.upload(src, "/data", pipeline=True)
+            await loader.download("/data/", tmp_path / "dst")
+
+            with pytest.raises(RuntimeError):
+                await loader.__aenter__()
+    finally:
+        metrics.set_sink(None)
+
+    # Every operation went through the same session.
+    assert sink.counter("pool_connections_opened_total") == 1
+    assert (tmp_path / "dst" / "1" / "1.txt").read_text() == "1"
+    assert (tmp_path / "dst" / "2.txt").read_text() == "2"
+
+
 @pytest.mark.asyncio
 async def test_download_file_to_file(tmp_path, ftp_server, connection_parameters):
     content = "test"
@@ -395,3 +437,212 @@ async def test_upload_no_data_to_upload(
 
     message = "No data to upload."
     assert message in caplog.text
+
+
+@pytest.mark.asyncio
+async def test_download_directory_to_directory_pipeline(
+    caplog, tmp_path, ftp_server, connection_parameters
+):
+    loader = FTPLoader(connections_parameters=connection_parameters, log_interval=1)
+
+    with caplog.at_level(logging.DEBUG, logger="pyftpkit"):
+        await loader.download("/", tmp_path, pipeline=True)
+
+    message = "No data found to download."
+    assert message in caplog.text
+
+    path = ftp_server.home / "1.txt"
+    path.write_text("")
+    path = ftp_server.home / "1"
+    path.mkdir()
+    path /= "1.txt"
+    path.write_text("")
+    path = ftp_server.home / "2" / "3"
+    path.mkdir(parents=True)
+    path /= "3.txt"
+    path.write_text("")
+
+    with caplog.at_level(logging.INFO, logger="pyftpkit"):
+        await loader.download("/", tmp_path, pipeline=True)
+
+    message = "Downloaded: 1"
+    assert message in caplog.text
+
+    message = "All downloads finished: 3"
+    assert message in caplog.text
+
+    assert os.path.isfile(tmp_path / "1.txt")
+    assert os.path.isfile(tmp_path / "1" / "1.txt")
+    assert os.path.isfile(tmp_path / "2" / "3" / "3.txt")
+
+
+@pytest.mark.asyncio
+async def test_upload_directory_to_directory_pipeline(
+    caplog, tmp_path, ftp_server, connection_parameters
+):
+    src = tmp_path / "src"
+    src.mkdir()
+
+    loader = FTPLoader(connections_parameters=connection_parameters, log_interval=1)
+
+    with caplog.at_level(logging.WARNING):
+        await loader.upload(src, "/", pipeline=True)
+
+    message = "No data to upload."
+    assert message in caplog.text
+
+    path = src / "1.txt"
+    path.write_text("")
+    path = src / "1"
+    path.mkdir()
+    path /= "1.txt"
+    path.write_text("")
+    path = src / "2" / "3"
+    path.mkdir(parents=True)
+    path /= "3.txt"
+    path.write_text("")
+
+    with caplog.at_level(logging.INFO, logger="pyftpkit"):
+        await loader.upload(src, "/data", pipeline=True)
+
+    message = "Uploaded: 1"
+    assert message in caplog.text
+
+    message = "All uploads finished: 3"
+    assert message in caplog.text
+
+    assert os.path.isfile(ftp_server.home / "data" / "1.txt")
+    assert os.path.isfile(ftp_server.home / "data" / "1" / "1.txt")
+    assert os.path.isfile(ftp_server.home / "data" / "2" / "3" / "3.txt")
+
+
+@pytest.mark.asyncio
+async def test_download_directory_to_directory_segmented(
+    tmp_path, ftp_server, connection_parameters
+):
+    connection_parameters.segment_threshold = 1
+
+    path = ftp_server.home / "1.txt"
+    path.write_text("test")
+    path = ftp_server.home / "1"
+    path.mkdir()
+    path /= "2.txt"
+    path.write_text("")
+
+    loader = FTPLoader(connections_parameters=connection_parameters)
+    await loader.download("/", tmp_path)
+
+    assert (tmp_path / "1.txt").read_text() == "test"
+    assert (tmp_path / "1" / "2.txt").read_text() == ""
+
+
+@pytest.mark.asyncio
+async def test_download_files_segmented(tmp_path, ftp_server, connection_parameters):
+    connection_parameters.segment_threshold = 1
+
+    (ftp_server.home / "1.txt").write_text("1")
+    (ftp_server.home / "2.txt").write_text("22")
+
+    loader = FTPLoader(connections_parameters=connection_parameters)
+    await loader.download(["/1.txt", "/2.txt"], tmp_path)
+
+    assert (tmp_path / "1.txt").read_text() == "1"
+    assert (tmp_path / "2.txt").read_text() == "22"
+
+
+@pytest.mark.asyncio
+async def test_sync(tmp_path, ftp_server, connection_parameters):
+    index = tmp_path / "index.trie"
+    dst = tmp_path / "data"
+
+    path = ftp_server.home / "1.txt"
+    path.write_text("1")
+    path = ftp_server.home / "1"
+    path.mkdir()
+    path /= "2.txt"
+    path.write_text("2")
+
+    loader = FTPLoader(connections_parameters=connection_parameters)
+
+    assert await loader.sync("/", dst, index=index) == 2
+    assert (dst / "1" / "2.txt").read_text() == "2"
+
+    # Nothing changed since the first run.
+    assert await loader.sync("/", dst, index=index) == 0
+
+    (ftp_server.home / "1.txt").write_text("11")
+    (dst / "1" / "2.txt").unlink()
+    (ftp_server.home / "3.txt").write_text("3")
+
+    assert await loader.sync("/", dst, index=index) == 3
+    assert (dst / "1.txt").read_text() == "11"
+    assert (dst / "1" / "2.txt").read_text() == "2"
+    assert (dst / "3.txt").read_text() == "3"
+
+
+@pytest.mark.asyncio
+async def test_sync_prune(tmp_path, ftp_server, connection_parameters):
+    index = tmp_path / "index.trie"
+    dst = tmp_path / "data"
+
+    for name in ("1", "2"):
+        path = ftp_server.home / name
+        path.mkdir()
+        (path / f"{name}.txt").write_text(name)
+        os.utime(path, (1_600_000_000, 1_600_000_000))
+
+    loader = FTPLoader(connections_parameters=connection_parameters)
+    assert await loader.sync("/", dst, index=index, prune=True) == 2
+
+    # A new entry updates the time of its directory, while rewriting a file in
+    # place leaves the time of the directory as it was.
+    (ftp_server.home / "1" / "3.txt").write_text("3")
+    os.utime(ftp_server.home / "1", (1_700_000_000, 1_700_000_000))
+    (ftp_server.home / "2" / "2.txt").write_text("22")
+    os.utime(ftp_server.home / "2", (1_600_000_000, 1_600_000_000))
+
+    assert await loader.sync("/", dst, index=index, prune=True) == 1
+    assert (dst / "1" / "3.txt").read_text() == "3"
+    assert (dst / "2" / "2.txt").read_text() == "2"
+
+    # The records of the skipped directory are carried over to the new index.
+    assert await loader.sync("/", dst, index=index) == 1
+    assert (dst / "2" / "2.txt").read_text() == "22"
+
+
+@pytest.mark.asyncio
+async def test_upload_directory_to_directory_pack(
+    caplog, tmp_path, ftp_server, connection_parameters
+):
+    src = tmp_path / "src"
+    (src / "1" / "2").mkdir(parents=True)
+    (src / "1.txt").write_text("1")
+    (src / "1" / "2" / "2.txt").write_text("")
+    (src / "3.bin").write_bytes(b"3" * 65_536)
+
+    loader = FTPLoader(connections_parameters=connection_parameters)
+
+    with pytest.raises(ValueError):
+        await loader.upload(src, "/data", pipeline=True, pack=True)
+
+    with caplog.at_level(logging.INFO, logger="pyftpkit"):
+        await loader.upload(src, "/data", pack=True)
+
+    message = "Packed 2 files into 1 archives."
+    assert message in caplog.text
+
+    # Large files are uploaded as they are.
+    home = ftp_server.home / "data"
+    assert (home / "3.bin").read_bytes() == b"3" * 65_536
+    assert not (home / "1.txt").exists()
+
+    with tarfile.open(home / ".pyftpkit-pack-00000.tar") as archive:
+        assert archive.getnames() == ["1.txt", "1/2/2.txt"]
+        assert archive.extractfile("1.txt").read() == b"1"
+
+    manifest = PathTrie.load(str(home / ".pyftpkit-pack.trie"))
+
+    mtime = int((src / "1.txt").stat().st_mtime)
+    assert manifest.metadata(".pyftpkit-pack-00000.tar/1.txt") == (1, mtime, False)
+    assert manifest.metadata(".pyftpkit-pack-00000.tar/1/2/2.txt") is not None
+    assert manifest.metadata(".pyftpkit-pack-00000.tar/3.bin") is None
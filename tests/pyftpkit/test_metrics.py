@@ -0,0 +1,101 @@
+# -*- coding: utf-8 -*-
+
+# Copyright 2025 (c) Vladislav Punko <iam.vlad.punko@gmail.com>
+
+import pytest
+
+from pyftpkit import metrics
+from pyftpkit.connection_parameters import ConnectionParameters
+from pyftpkit.ftpfs import FTPFileSystem
+
+
+@pytest.fixture
+def connection_parameters(username, password, ftp_server):
+    return ConnectionParameters.model_validate(
+        {
+            "host": ftp_server.host,
+            "port": ftp_server.port,
+            "credentials": {
+                "username": username,
+                "password": password,
+            },
+            "max_connections": 2,
+            "max_workers": 4,
+        }
+    )
+
+
+@pytest.fixture
+def sink():
+    sink = metrics.InMemorySink()
+    metrics.set_sink(sink)
+
+    yield sink
+
+    metrics.set_sink(None)
+
+
+def test_no_sink(mocker):
+    sink = mocker.Mock()
+    metrics.set_sink(sink)
+    metrics.set_sink(None)
+
+    assert not metrics.enabled()
+    assert metrics.get_sink() is None
+
+    metrics.increment("counter")
+    metrics.observe("histogram", 1.0)
+    metrics.gauge("gauge", 1.0)
+
+    sink.increment.assert_not_called()
+    sink.observe.assert_not_called()
+    sink.gauge.assert_not_called()
+
+
+def test_in_memory_sink(sink):
+    assert metrics.enabled()
+    assert metrics.get_sink() is sink
+
+    metrics.increment("counter")
+    metrics.increment("counter", 2, direction="upload")
+    metrics.increment("counter", 3, direction="upload")
+
+    assert sink.counter("counter") == 1
+    assert sink.counter("counter", direction="upload") == 5
+    assert sink.counter("counter", direction="download") == 0
+
+    metrics.observe("histogram", 2.0)
+    metrics.observe("histogram", 1.0)
+    metrics.observe("histogram", 3.0)
+
+    assert sink.histogram("histogram") == (3, 6.0, 1.0, 3.0)
+    assert sink.histogram("histogram", command="LIST") is None
+
+    metrics.gauge("gauge", 1.0)
+    metrics.gauge("gauge", 0.0)
+
+    assert sink.gauges[("gauge", ())] == 0.0
+
+
+@pytest.mark.asyncio
+async def test_walk_metrics(sink, ftp_server, connection_parameters):
+    (ftp_server.home / "1").mkdir()
+    (ftp_server.home / "1" / "1.txt").write_text("1")
+
+    async with FTPFileSystem(connection_parameters=connection_parameters) as ftpfs:
+        async for _ in ftpfs.walk(ftp_server.root):
+            pass
+
+    assert sink.counter("pool_connections_opened_total") == 2
+    assert sink.counter("pool_acquired_total") >= 2
+
+    assert sink.histogram("pool_wait_seconds").count >= 1
+    assert sink.histogram("listing_parse_seconds").count == 2
+    assert sink.histogram("listing_entries").count == 2
+
+    # Logins time the command without its argument.
+    assert sink.histogram("ftp_command_seconds", command="PASS").count == 2
+    assert sink.histogram("ftp_command_seconds", command="TYPE").count >= 1
+
+    assert ("walk_queue_depth", ()) in sink.gauges
+    assert ("walk_output_queue_depth", ()) in sink.gauges
@@ -2,6 +2,9 @@
 
 # Copyright 2025 (c) Vladislav Punko <iam.vlad.punko@gmail.com>
 
+import os
+import pathlib
+
 import pytest
 
 from pyftpkit._pathtrie import PathTrie
@@ -21,7 +24,8 @@ from pyftpkit._pathtrie import PathTrie
         (["/1/2/"], ["/", "/1", "/1/2"]),
         (["/a", "/a/b"], ["/", "/a", "/a/b"]),
         (["/a/./b"], ["/", "/a", "/a/b"]),
-        (["/a/b", "/c"], ["/", "/c", "/a", "/a/b"]),
+        (["/a/b", "/c"], ["/", "/a", "/a/b", "/c"]),
+        (["/c", "/a/b"], ["/", "/a", "/a/b", "/c"]),
         (["/а/б/в"], ["/", "/а", "/а/б", "/а/б/в"]),
         (["/漢字/テスト"], ["/", "/漢字", "/漢字/テスト"]),
     ],
@@ -58,3 +62,333 @@ def test_get_all_unique_paths():
         "/1",
         "/1/2",
     }
+
+
+def test_clear_and_reuse():
+    trie = PathTrie()
+    for _ in range(3):
+        for index in range(1000):
+            trie.insert(f"/{index % 10}/{index}")
+        assert len(trie.get_all_unique_paths()) == 1 + 10 + 1000
+
+        trie.clear()
+        assert trie.get_all_unique_paths() == []
+
+
+def test_clear_during_iteration():
+    trie = PathTrie()
+    trie.insert("/1/2")
+
+    iterator = iter(trie)
+    next(iterator)
+
+    trie.clear()
+    with pytest.raises(RuntimeError):
+        next(iterator)
+
+
+def test_insert_existing_prefixes():
+    trie = PathTrie()
+    trie.insert("/a/b/c")
+    trie.insert("/a/b")
+    trie.insert("/a/b/c/")
+
+    assert trie.get_all_unique_paths() == ["/", "/a", "/a/b", "/a/b/c"]
+
+
+@pytest.mark.parametrize(
+    "paths",
+    [
+        ["/a/b/../c", "/a/./d//", "/../e"],
+        [pathlib.Path("/a/c"), pathlib.Path("/a/d"), b"/e"],
+        (path for path in ["/a/c", "/a/d/", "/e/f/.."]),
+    ],
+)
+def test_insert_many(paths):
+    trie = PathTrie()
+    trie.insert_many(paths)
+
+    assert set(trie) == {"/", "/a", "/a/c", "/a/d", "/e"}
+
+
+def test_insert_many_normpath():
+    paths = ["../a/b", "a/../../b", "/a/b/../../..", "x/./y//z/", "."]
+
+    trie = PathTrie()
+    trie.insert_many(paths)
+
+    expected_trie = PathTrie()
+    for path in paths:
+        expected_trie.insert(os.path.normpath(path))
+
+    assert set(trie.get_all_unique_paths()) == set(
+        expected_trie.get_all_unique_paths()
+    )
+
+
+def test_insert_many_buffer():
+    trie = PathTrie()
+    trie.insert_many(b"/a/b\n/a/c\x00/d/../e\n\n")
+
+    assert set(trie) == {"/", "/a", "/a/b", "/a/c", "/e"}
+
+
+def test_insert_many_invalid_type():
+    trie = PathTrie()
+
+    with pytest.raises(TypeError):
+        trie.insert_many([1, 2, 3])
+
+
+@pytest.mark.parametrize("threads", [0, 2, 4])
+def test_insert_many_threads(threads):
+    paths = [f"/{index % 17}/{index % 1000}/../{index}" for index in range(100_000)]
+
+    trie = PathTrie()
+    trie.insert_many(paths, threads=threads)
+
+    expected_trie = PathTrie()
+    expected_trie.insert_many(paths)
+
+    assert set(trie) == set(expected_trie)
+    assert len(trie.get_all_unique_paths()) == 1 + 17 + 100_000
+
+
+def test_insert_many_threads_buffer():
+    buffer = b"\n".join(b"/%d/%d" % (index % 7, index) for index in range(100_000))
+
+    trie = PathTrie()
+    trie.insert("/0/existing")
+    trie.insert_many(buffer, threads=4)
+
+    paths = trie.get_all_unique_paths()
+    assert len(paths) == len(set(paths)) == 1 + 7 + 100_000 + 1
+
+
+def test_levels():
+    trie = PathTrie()
+    trie.insert_many(["/a/b/c", "/a/d", "/e"])
+
+    levels = [sorted(level) for level in trie.levels()]
+    assert levels == [["/"], ["/a", "/e"], ["/a/b", "/a/d"], ["/a/b/c"]]
+
+
+def test_levels_empty():
+    assert list(PathTrie().levels()) == []
+
+
+@pytest.mark.parametrize(
+    "path, expected_paths",
+    [
+        ("../a/b", ["/", "/a", "/a/b"]),
+        ("/a/../b", ["/", "/a", "/b"]),
+        ("/../../a", ["/", "/a"]),
+        ("a/b/../../c", ["a", "a/b", "c"]),
+    ],
+)
+def test_insert_parent_references(path, expected_paths):
+    trie = PathTrie()
+    trie.insert(path)
+
+    assert sorted(trie) == sorted(trie.get_all_unique_paths()) == expected_paths
+
+
+def test_next_batch():
+    trie = PathTrie()
+    trie.insert_many([f"/{index}" for index in range(10)])
+
+    iterator = iter(trie)
+    assert next(iterator) == "/"
+
+    batch = iterator.next_batch(4)
+    assert len(batch) == 4
+
+    rest = iterator.next_batch(100)
+    assert len(rest) == 6
+    assert iterator.next_batch(100) == []
+
+    assert set(batch + rest) == {f"/{index}" for index in range(10)}
+
+
+@pytest.mark.parametrize("batch_size", [1, 3, 1000])
+def test_iter_batch_size(batch_size):
+    trie = PathTrie()
+    trie.insert_many([f"/a/{index}" for index in range(10)])
+
+    batches = list(trie.__iter__(batch_size=batch_size))
+    assert all(0 < len(batch) <= batch_size for batch in batches)
+    assert [path for batch in batches for path in batch] == list(trie)
+
+
+@pytest.mark.parametrize("count", [3, 17, 1000])
+def test_sorted_children(count):
+    names = [str(index) for index in range(count)]
+
+    trie = PathTrie()
+    for name in reversed(names):
+        trie.insert(f"/{name}")
+    trie.insert("/")
+
+    assert list(trie) == ["/"] + [f"/{name}" for name in sorted(names)]
+    assert trie.get_all_unique_paths() == list(trie)
+    assert [sorted(level) for level in trie.levels()] == list(trie.levels())
+
+
+@pytest.mark.parametrize("mmap", [True, False])
+def test_save_load(tmp_path, mmap):
+    pathtrie = PathTrie()
+    pathtrie.insert_many([f"/a/{i}/b" for i in range(100)] + ["c/d"])
+    pathtrie.save(tmp_path / "paths.trie")
+
+    loaded = PathTrie.load(tmp_path / "paths.trie", mmap=mmap)
+
+    assert list(loaded) == list(pathtrie)
+    assert list(loaded.levels()) == list(pathtrie.levels())
+    assert loaded.get_all_unique_paths() == pathtrie.get_all_unique_paths()
+
+
+def test_save_load_empty(tmp_path):
+    PathTrie().save(tmp_path / "paths.trie")
+
+    assert list(PathTrie.load(tmp_path / "paths.trie")) == []
+
+
+def test_load_insert(tmp_path):
+    pathtrie = PathTrie()
+    pathtrie.insert("/a/b")
+    pathtrie.save(tmp_path / "paths.trie")
+
+    loaded = PathTrie.load(tmp_path / "paths.trie")
+    iterator = iter(loaded)
+    loaded.insert("/a/c")
+
+    assert loaded.get_all_unique_paths() == ["/", "/a", "/a/b", "/a/c"]
+
+    with pytest.raises(RuntimeError):
+        next(iterator)
+
+
+def test_load_invalid(tmp_path):
+    (tmp_path / "paths.trie").write_bytes(b"not a snapshot" * 10)
+
+    with pytest.raises(ValueError):
+        PathTrie.load(tmp_path / "paths.trie")
+
+    with pytest.raises(FileNotFoundError):
+        PathTrie.load(tmp_path / "missing.trie")
+
+
+@pytest.mark.parametrize("mmap", [False, True])
+def test_contains(tmp_path, mmap):
+    pathtrie = PathTrie()
+    pathtrie.insert_many(["/a/b/c", "d/e"] + [f"/wide/{i}" for i in range(50)])
+
+    if mmap:
+        pathtrie.save(tmp_path / "paths.trie")
+        pathtrie = PathTrie.load(tmp_path / "paths.trie")
+
+    assert pathtrie.contains("/a/b")
+    assert pathtrie.contains("/a/b/c/")
+    assert pathtrie.contains("/a/./b/../b")
+    assert pathtrie.contains("/wide/42")
+    assert "d/e" in pathtrie
+    assert "/d/e" not in pathtrie
+    assert not pathtrie.contains("/a/x")
+    assert not pathtrie.contains("")
+
+
+@pytest.mark.parametrize(
+    "path, expected_prefix",
+    [
+        ("/a/b/x/y", "/a/b"),
+        ("/a/b/c", "/a/b/c"),
+        ("/x", "/"),
+        ("d/e/f", "d/e"),
+        ("x/y", None),
+    ],
+)
+def test_longest_existing_prefix(path, expected_prefix):
+    pathtrie = PathTrie()
+    pathtrie.insert_many(["/a/b/c", "d/e"])
+
+    assert pathtrie.longest_existing_prefix(path) == expected_prefix
+
+
+def test_missing_from():
+    known = PathTrie()
+    known.insert_many(["/a/b", "/c"])
+
+    wanted = PathTrie()
+    wanted.insert_many(["/a/b/d", "/a/e", "/c", "f/g"])
+
+    assert wanted.missing_from(known) == ["/a/b/d", "/a/e", "f", "f/g"]
+    assert known.missing_from(known) == []
+
+
+def test_ref_count():
+    pathtrie = PathTrie()
+
+    assert pathtrie.add_ref("/a/b", 2) == 2
+    assert pathtrie.add_ref("/a") == 1
+    assert pathtrie.ref_count("/a/./b/") == 2
+    assert pathtrie.ref_count("/c") == 0
+    assert "/a/b" in pathtrie
+
+    assert pathtrie.release("/a/b") == 1
+    assert pathtrie.release("/a/b") == 0
+    assert pathtrie.release("/a") == 0
+
+    with pytest.raises(ValueError):
+        pathtrie.release("/a")
+
+    with pytest.raises(ValueError):
+        pathtrie.release("/c")
+
+    with pytest.raises(ValueError):
+        pathtrie.add_ref("")
+
+    pathtrie.clear()
+    assert pathtrie.ref_count("/a/b") == 0
+
+
+@pytest.mark.parametrize("mmap", [False, True])
+def test_metadata(tmp_path, mmap):
+    pathtrie = PathTrie()
+    pathtrie.insert("/a/b")
+    pathtrie.set_metadata("/a/c.txt", 10, 1700000000)
+    pathtrie.set_metadata("/a", mtime=1600000000, is_dir=True)
+    pathtrie.insert_many([f"/wide/{i}" for i in range(50)])
+    pathtrie.set_metadata("/wide/42", 42)
+
+    pathtrie.save(tmp_path / "paths.trie")
+    loaded = PathTrie.load(tmp_path / "paths.trie", mmap=mmap)
+
+    for trie in (pathtrie, loaded):
+        assert trie.metadata("/a/./c.txt") == (10, 1700000000, False)
+        assert trie.metadata("/a") == (-1, 1600000000, True)
+        assert trie.metadata("/wide/42") == (42, -1, False)
+        assert trie.metadata("/a/b") is None
+        assert trie.metadata("/x") is None
+
+    # Copying a mapped trie keeps its metadata.
+    loaded.insert("/d")
+    assert loaded.metadata("/a/c.txt") == (10, 1700000000, False)
+
+    with pytest.raises(ValueError):
+        pathtrie.set_metadata("", 1)
+
+    pathtrie.clear()
+    assert pathtrie.metadata("/a/c.txt") is None
+
+
+def test_metadata_insert_many():
+    pathtrie = PathTrie()
+    pathtrie.set_metadata("/a", 1)
+    pathtrie.set_metadata("/c/7", 7)
+
+    # Parallel insertions merge private tries into the existing one.
+    pathtrie.insert_many([f"/c/{i}" for i in range(40_000)], threads=2)
+
+    assert pathtrie.metadata("/a") == (1, -1, False)
+    assert pathtrie.metadata("/c/7") == (7, -1, False)
+    assert pathtrie.metadata("/c/8") is None
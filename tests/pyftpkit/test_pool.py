@@ -5,12 +5,13 @@
 import asyncio
 import ftplib
 import logging
+import socket
 import time
 
 import pytest
 
 from pyftpkit._pool import FTPPoolExecutor
-from pyftpkit.connection_parameters import ConnectionParameters
+from pyftpkit.connection_parameters import ConnectionParameters, Endpoint
 from pyftpkit.exceptions import FTPError
 
 
@@ -75,15 +76,37 @@ async def test_open_connections(caplog, connection_parameters, ftp_server):
 
     with caplog.at_level(logging.DEBUG, logger="pyftpkit"):
         async with FTPPoolExecutor(connection_parameters=connection_parameters) as pool:
-            assert pool._pool.qsize() == connection_parameters.max_connections
-            assert len(pool._connections) == connection_parameters.max_connections
+            assert pool.qsize() == connection_parameters.max_connections
+            assert len(pool._connections) == connection_parameters.min_connections
 
     message = "FTP connection pool has been initialized with {0!s} connections.".format(
-        connection_parameters.max_connections
+        connection_parameters.min_connections
     )
     assert message in caplog.text
 
 
+@pytest.mark.asyncio
+async def test_open_connections_on_demand(connection_parameters, ftp_server):
+    connection_parameters.host = ftp_server.host
+    connection_parameters.port = ftp_server.port
+    connection_parameters.max_connections = 2
+
+    async with FTPPoolExecutor(connection_parameters=connection_parameters) as pool:
+        ftp = await pool.get()
+        await pool.release(ftp)
+
+        # An idle connection is reused before the pool grows.
+        assert await pool.get() is ftp
+        assert len(pool._connections) == 1
+
+        other_ftp = await pool.get()
+        assert other_ftp is not ftp
+        assert len(pool._connections) == 2
+
+        await pool.release(ftp)
+        await pool.release(other_ftp)
+
+
 @pytest.mark.asyncio
 async def test_open_connections_timeout(mocker, caplog, connection_parameters):
     def _connect(*args, **kwargs):
@@ -108,6 +131,7 @@ async def test_open_only_once(mocker, connection_parameters, ftp_server):
     connection_parameters.host = ftp_server.host
     connection_parameters.port = ftp_server.port
     connection_parameters.max_connections = 2
+    connection_parameters.min_connections = 2
     connect_mock = mocker.patch("pyftpkit._pool.FTPPoolExecutor._connect")
 
     pool = FTPPoolExecutor(connection_parameters=connection_parameters)
@@ -209,6 +233,205 @@ def test_close_connection_with_exceptions(
     assert message in str(err.value)
 
 
+@pytest.mark.asyncio
+async def test_release_closed_connection(caplog, ftp_server, connection_parameters):
+    connection_parameters.host = ftp_server.host
+    connection_parameters.port = ftp_server.port
+    connection_parameters.max_connections = 1
+
+    async with FTPPoolExecutor(connection_parameters=connection_parameters) as pool:
+        ftp = await pool.get()
+        ftp.close()
+
+        with caplog.at_level(logging.WARNING, logger="pyftpkit"):
+            await pool.release(ftp)
+
+        message = "A dead FTP connection has been evicted from the pool."
+        assert message in caplog.text
+
+        # The free slot is refilled with a working connection.
+        other_ftp = await pool.get()
+        assert other_ftp is not ftp
+        assert other_ftp.voidcmd("NOOP").startswith("200")
+
+        await pool.release(other_ftp)
+
+
+@pytest.mark.asyncio
+async def test_get_idle_connection(mocker, ftp_server, connection_parameters):
+    connection_parameters.host = ftp_server.host
+    connection_parameters.port = ftp_server.port
+    connection_parameters.max_connections = 1
+
+    async with FTPPoolExecutor(connection_parameters=connection_parameters) as pool:
+        ftp = await pool.get()
+        await pool.release(ftp)
+
+        # Pretend the connection has been idle for longer than the interval.
+        pool._idle_since[ftp] -= connection_parameters.keepalive_interval
+        mocker.patch.object(ftp, "voidcmd", side_effect=ftplib.error_temp("421"))
+
+        other_ftp = await pool.get()
+        assert other_ftp is not ftp
+        assert ftp not in pool._connections
+
+        ftp.voidcmd.assert_called_once_with("NOOP")
+
+        await pool.release(other_ftp)
+
+
+@pytest.mark.asyncio
+async def test_keep_alive(mocker, ftp_server, connection_parameters):
+    connection_parameters.host = ftp_server.host
+    connection_parameters.port = ftp_server.port
+    connection_parameters.keepalive_interval = 1
+
+    async with FTPPoolExecutor(connection_parameters=connection_parameters) as pool:
+        ftp = await pool.get()
+        await pool.release(ftp)
+
+        voidcmd_mock = mocker.spy(ftp, "voidcmd")
+        await asyncio.sleep(2.5)
+
+        voidcmd_mock.assert_any_call("NOOP")
+
+        # The connection is still the first to be handed out.
+        assert await pool.get() is ftp
+        await pool.release(ftp)
+
+
+@pytest.mark.asyncio
+async def test_reuse_idle_after_eviction(ftp_server, connection_parameters):
+    connection_parameters.host = ftp_server.host
+    connection_parameters.port = ftp_server.port
+    connection_parameters.max_connections = 2
+    connection_parameters.min_connections = 2
+
+    async with FTPPoolExecutor(connection_parameters=connection_parameters) as pool:
+        idle, dead = await pool.get(), await pool.get()
+        await pool.release(idle)
+
+        # The slot of the evicted session goes below the idle one.
+        dead.close()
+        await pool.release(dead)
+        assert dead not in pool._connections
+
+        assert await pool.get() is idle
+        assert len(pool._connections) == 1
+        await pool.release(idle)
+
+
+@pytest.mark.asyncio
+async def test_route_to_mirrors(ftp_server, connection_parameters):
+    connection_parameters.host = ftp_server.host
+    connection_parameters.port = ftp_server.port
+    connection_parameters.max_connections = 2
+    connection_parameters.min_connections = 3
+    connection_parameters.mirrors = [
+        Endpoint(host=ftp_server.host, port=ftp_server.port, max_connections=1)
+    ]
+
+    async with FTPPoolExecutor(connection_parameters=connection_parameters) as pool:
+        assert pool.qsize() == 3
+        assert len(pool._connections) == 3
+
+        main, mirror = pool._endpoints
+        main.latency, mirror.latency = 1.0, 0.1
+
+        # The mirror answers faster, so it gets the first operation.
+        ftp = await pool.get()
+        assert pool._owners[ftp] is mirror
+
+        # Its only session is busy, so the rest goes to the main server.
+        others = [await pool.get(), await pool.get()]
+        assert all(pool._owners[other] is main for other in others)
+
+        with pytest.raises(asyncio.TimeoutError):
+            await asyncio.wait_for(pool.get(), timeout=0.5)
+
+        for connection in (ftp, *others):
+            await pool.release(connection)
+
+        assert main.in_flight == mirror.in_flight == 0
+        assert pool.qsize() == 3
+
+
+@pytest.mark.asyncio
+async def test_route_around_unreachable_mirror(ftp_server, connection_parameters):
+    # Nothing listens on a port that was just given up.
+    with socket.socket(socket.AF_INET, socket.SOCK_STREAM) as sock:
+        sock.bind(("127.0.0.1", 0))
+        closed_port = sock.getsockname()[1]
+
+    connection_parameters.host = ftp_server.host
+    connection_parameters.port = ftp_server.port
+    connection_parameters.max_connections = 2
+    connection_parameters.min_connections = 2
+    connection_parameters.mirrors = [
+        Endpoint(host="127.0.0.1", port=closed_port, max_connections=1)
+    ]
+
+    async with FTPPoolExecutor(connection_parameters=connection_parameters) as pool:
+        main, mirror = pool._endpoints
+
+        # The pool opens without the mirror, which is backed off from.
+        assert len(pool._connections) == 1
+        assert mirror.failures == 1
+
+        first = await pool.get()
+        assert pool._owners[first] is main
+        await pool.release(first)
+
+        # Once the back-off ends, the faster mirror is tried again and the get
+        # moves on to the main server.
+        mirror.recover()
+        main.latency, mirror.latency = 1.0, 0.1
+
+        others = [await pool.get(), await pool.get()]
+        assert all(pool._owners[other] is main for other in others)
+        assert mirror.failures == 1
+
+        # The mirror is left alone while it is backing off.
+        with pytest.raises(asyncio.TimeoutError):
+            await asyncio.wait_for(pool.get(), timeout=0.5)
+
+        assert mirror.failures == 1
+
+        for connection in others:
+            await pool.release(connection)
+
+        assert main.in_flight == mirror.in_flight == 0
+
+
+@pytest.mark.asyncio
+async def test_evict_interrupted_session(ftp_server, connection_parameters):
+    (ftp_server.home / "text.txt").write_text("")
+
+    connection_parameters.host = ftp_server.host
+    connection_parameters.port = ftp_server.port
+    connection_parameters.backend = "asyncio"
+
+    async with FTPPoolExecutor(connection_parameters=connection_parameters) as pool:
+        ftp = await pool.get()
+
+        def cancel(chunk):
+            raise asyncio.CancelledError()
+
+        # The listing is cancelled before its final reply has been read.
+        with pytest.raises(asyncio.CancelledError):
+            await ftp.retrbinary("LIST -a", cancel)
+
+        assert ftp.closed
+
+        await pool.release(ftp)
+        assert ftp not in pool._connections
+
+        other = await pool.get()
+        assert other is not ftp
+        assert (await other.voidcmd("NOOP")).startswith("200")
+        await pool.release(other)
+
+
 @pytest.mark.asyncio
 async def test_close_no_pool(caplog, connection_parameters):
     pool = FTPPoolExecutor(connection_parameters=connection_parameters)
@@ -229,6 +452,7 @@ async def test_close_only_once(mocker, ftp_server, connection_parameters):
     connection_parameters.host = ftp_server.host
     connection_parameters.port = ftp_server.port
     connection_parameters.max_connections = 2
+    connection_parameters.min_connections = 2
     pool = FTPPoolExecutor(connection_parameters=connection_parameters)
     await pool.open()
     await pool.close()
@@ -251,7 +475,7 @@ async def test_close(caplog, ftp_server, connection_parameters):
     assert message in caplog.text
 
     assert not pool._connections
-    assert pool._pool.qsize() == 0
+    assert pool.qsize() == 0
 
 
 @pytest.mark.asyncio
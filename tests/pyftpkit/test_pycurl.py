@@ -11,8 +11,8 @@ from unittest import mock
 import pycurl
 import pytest
 
-from pyftpkit._pycurl import PycURL
-from pyftpkit.connection_parameters import ConnectionParameters
+from pyftpkit._pycurl import _MIN_SEGMENT_SIZE, PycURL, _FileSink
+from pyftpkit.connection_parameters import ConnectionParameters, Endpoint
 from pyftpkit.exceptions import FTPError
 
 
@@ -146,7 +146,7 @@ def test_download(
     ]
     pycurl_mock.return_value.setopt.assert_has_calls(expected_calls, any_order=False)
     pycurl_mock.return_value.perform.assert_called_once()
-    pycurl_mock.return_value.close.assert_called_once()
+    pycurl_mock.return_value.close.assert_not_called()
 
 
 def test_download_with_error(
@@ -231,7 +231,7 @@ def test_upload(
     ]
     pycurl_mock.return_value.setopt.assert_has_calls(expected_calls, any_order=False)
     pycurl_mock.return_value.perform.assert_called_once()
-    pycurl_mock.return_value.close.assert_called_once()
+    pycurl_mock.return_value.close.assert_not_called()
 
 
 def test_upload_with_error(
@@ -269,3 +269,371 @@ def test_upload_with_fs_error(caplog, fs_no_root, pycurl_mock, pycurl_instance):
 
     message = f"An error occurred while accessing the local file: {src!s}."
     assert message in str(err.value)
+
+
+def test_upload_stream(fs_no_root, pycurl_mock, pycurl_instance):
+    stream = io.BytesIO(b"test")
+
+    pycurl_instance.upload_stream(stream, "/text.txt", 4)
+
+    pycurl_mock.return_value.setopt.assert_any_call(pycurl.INFILESIZE, 4)
+    pycurl_mock.return_value.perform.assert_called_once()
+
+    # cURL pulls the data through the read callback.
+    read = next(
+        call.args[1]
+        for call in pycurl_mock.return_value.setopt.call_args_list
+        if call.args[0] == pycurl.READFUNCTION
+    )
+    assert read(16_384) == b"test"
+    assert read(16_384) == b""
+
+
+def test_upload_stream_with_read_error(fs_no_root, pycurl_mock, pycurl_instance):
+    stream = mock.Mock()
+    stream.read.side_effect = OSError("error")
+
+    def perform():
+        read = next(
+            call.args[1]
+            for call in pycurl_mock.return_value.setopt.call_args_list
+            if call.args[0] == pycurl.READFUNCTION
+        )
+        assert read(16_384) == pycurl.READFUNC_ABORT
+        raise pycurl.error("error")
+
+    pycurl_mock.return_value.perform.side_effect = perform
+    with pytest.raises(RuntimeError) as err:
+        pycurl_instance.upload_stream(stream, "/text.txt", 4)
+
+    assert isinstance(err.value.__cause__, OSError)
+
+
+def test_reuse_handle(fs_no_root, pycurl_mock, pycurl_instance):
+    src = pathlib.Path("text.txt")
+    src.write_text("test")
+
+    pycurl_instance.download("/text.txt", "1.txt")
+    pycurl_instance.upload(src, "/text.txt")
+    pycurl_instance.download("/text.txt", "2.txt")
+
+    pycurl_mock.assert_called_once()
+    assert pycurl_mock.return_value.reset.call_count == 2
+    assert pycurl_mock.return_value.perform.call_count == 3
+
+    pycurl_instance.close()
+    pycurl_mock.return_value.close.assert_called_once()
+
+
+def test_route_to_mirror(fs_no_root, pycurl_mock, host, port, connection_parameters):
+    connection_parameters.mirrors = [Endpoint(host="mirror", port=2121)]
+    pycurl_instance = PycURL(connection_parameters=connection_parameters)
+
+    # Also taken as the time to the first byte of the main server.
+    pycurl_mock.return_value.getinfo.return_value = 1024
+
+    pycurl_instance.download("/1.txt", "1.txt")
+    pycurl_instance.download("/2.txt", "2.txt")
+
+    urls = [
+        call.args[1]
+        for call in pycurl_mock.return_value.setopt.call_args_list
+        if call.args[0] == pycurl.URL
+    ]
+    assert urls == [f"ftp://{host!s}:{port!s}/1.txt", "ftp://mirror:2121/2.txt"]
+
+    assert all(endpoint.in_flight == 0 for endpoint in pycurl_instance._endpoints)
+
+
+def test_route_around_unreachable_mirror(
+    fs_no_root, pycurl_mock, host, port, connection_parameters
+):
+    connection_parameters.mirrors = [Endpoint(host="mirror", port=2121)]
+    pycurl_instance = PycURL(connection_parameters=connection_parameters)
+
+    pycurl_mock.return_value.getinfo.return_value = 1024
+
+    urls = []
+
+    def setopt(option, value):
+        if option == pycurl.URL:
+            urls.append(value)
+
+    def perform():
+        if urls[-1].startswith("ftp://mirror"):
+            raise pycurl.error(pycurl.E_COULDNT_CONNECT, "Failed to connect")
+
+    pycurl_mock.return_value.setopt.side_effect = setopt
+    pycurl_mock.return_value.perform.side_effect = perform
+
+    pycurl_instance.download("/1.txt", "1.txt")
+    with pytest.raises(FTPError):
+        pycurl_instance.download("/2.txt", "2.txt")
+
+    # The mirror is backed off from, so the main server takes the next ones.
+    pycurl_instance.download("/3.txt", "3.txt")
+    pycurl_instance.download("/4.txt", "4.txt")
+
+    assert urls == [
+        f"ftp://{host!s}:{port!s}/1.txt",
+        "ftp://mirror:2121/2.txt",
+        f"ftp://{host!s}:{port!s}/3.txt",
+        f"ftp://{host!s}:{port!s}/4.txt",
+    ]
+
+    main, mirror = pycurl_instance._endpoints
+    assert mirror.failures == 1
+    assert main.in_flight == mirror.in_flight == 0
+
+
+def test_download_many(fs_no_root, mocker, pycurl_mock, pycurl_instance):
+    multi_mock = mocker.patch("pyftpkit._pycurl.pycurl.CurlMulti")
+    multi_mock.return_value.perform.return_value = (0, 1)
+    multi_mock.return_value.info_read.return_value = (
+        0,
+        [pycurl_mock.return_value],
+        [],
+    )
+    pycurl_mock.return_value.getinfo.return_value = 1024
+
+    progress = mock.Mock()
+    size_bytes = pycurl_instance.download_many(
+        ["/1.txt", "/2.txt"], ["1.txt", "2.txt"], concurrency=1, progress=progress
+    )
+    assert size_bytes == 2048
+    assert progress.call_count == 2
+
+    assert os.path.isfile("1.txt")
+    assert os.path.isfile("2.txt")
+
+    # The next batch runs over the same handles and their connections.
+    pycurl_instance.download_many(["/3.txt"], ["3.txt"], concurrency=1)
+
+    multi_mock.assert_called_once()
+    pycurl_mock.assert_called_once()
+    multi_mock.return_value.close.assert_not_called()
+    pycurl_mock.return_value.close.assert_not_called()
+
+    pycurl_instance.close()
+    multi_mock.return_value.close.assert_called_once()
+    pycurl_mock.return_value.close.assert_called_once()
+
+
+def test_size_many(caplog, fs_no_root, mocker, pycurl_mock, pycurl_instance):
+    multi_mock = mocker.patch("pyftpkit._pycurl.pycurl.CurlMulti")
+    multi_mock.return_value.perform.return_value = (0, 1)
+    multi_mock.return_value.info_read.side_effect = [
+        (0, [pycurl_mock.return_value], []),
+        (0, [], [(pycurl_mock.return_value, pycurl.E_FTP_COULDNT_RETR_FILE, "error")]),
+    ]
+    pycurl_mock.return_value.getinfo.return_value = 1024
+
+    # A failed request leaves the file without a size instead of raising.
+    with caplog.at_level(logging.WARNING):
+        sizes = pycurl_instance.size_many(["/1.txt", "/2.txt"], concurrency=1)
+
+    assert sizes == [1024, None]
+    assert "Failed to request the size of" in caplog.text
+
+    pycurl_mock.return_value.setopt.assert_any_call(pycurl.NOBODY, 1)
+    multi = multi_mock.return_value
+    assert multi.add_handle.call_count == multi.remove_handle.call_count == 2
+
+
+def test_download_many_with_error(
+    caplog, fs_no_root, host, port, mocker, pycurl_mock, pycurl_instance
+):
+    multi_mock = mocker.patch("pyftpkit._pycurl.pycurl.CurlMulti")
+    multi_mock.return_value.perform.return_value = (0, 1)
+    multi_mock.return_value.info_read.return_value = (
+        0,
+        [],
+        [(pycurl_mock.return_value, pycurl.E_COULDNT_CONNECT, "error")],
+    )
+
+    src = "text.txt"
+    with caplog.at_level(logging.ERROR):
+        with pytest.raises(FTPError) as err:
+            pycurl_instance.download_many([src], ["text.txt"], concurrency=1)
+
+    message = "An unexpected error occurred while fetching the data."
+    assert message in caplog.text
+
+    message = "Encountered an error while trying to fetch the data from: {0!s}".format(
+        f"ftp://{host!s}:{port!s}/{src!s}"
+    )
+    assert message in str(err.value)
+
+    # No handle is left attached to the multi handle kept for the next batch.
+    multi = multi_mock.return_value
+    assert multi.add_handle.call_count == multi.remove_handle.call_count
+
+
+def test_download_many_retry(caplog, fs_no_root, mocker, pycurl_mock, pycurl_instance):
+    multi_mock = mocker.patch("pyftpkit._pycurl.pycurl.CurlMulti")
+    multi_mock.return_value.perform.return_value = (0, 1)
+    multi_mock.return_value.info_read.side_effect = [
+        (0, [], [(pycurl_mock.return_value, pycurl.E_COULDNT_CONNECT, "error")]),
+        (0, [pycurl_mock.return_value], []),
+    ]
+    pycurl_mock.return_value.getinfo.return_value = 1024
+
+    with caplog.at_level(logging.WARNING):
+        size_bytes = pycurl_instance.download_many(["/1.txt"], ["1.txt"])
+
+    assert size_bytes == 1024
+    assert multi_mock.return_value.add_handle.call_count == 2
+
+    message = "Transfer from '/1.txt' to '1.txt' failed, retrying: error"
+    assert message in caplog.text
+
+
+def test_download_many_partial_failure(
+    fs_no_root, host, port, mocker, pycurl_mock, connection_parameters, pycurl_instance
+):
+    connection_parameters.retries = 0
+
+    multi_mock = mocker.patch("pyftpkit._pycurl.pycurl.CurlMulti")
+    multi_mock.return_value.perform.return_value = (0, 1)
+    multi_mock.return_value.info_read.side_effect = [
+        (0, [], [(pycurl_mock.return_value, pycurl.E_COULDNT_CONNECT, "error")]),
+        (0, [pycurl_mock.return_value], []),
+    ]
+    pycurl_mock.return_value.getinfo.return_value = 1024
+
+    # The second file is still fetched after the first one failed.
+    with pytest.raises(FTPError) as err:
+        pycurl_instance.download_many(
+            ["/1.txt", "/2.txt"], ["1.txt", "2.txt"], concurrency=1
+        )
+
+    assert f"ftp://{host!s}:{port!s}/1.txt" in str(err.value)
+    assert multi_mock.return_value.add_handle.call_count == 2
+    assert os.path.isfile("2.txt")
+
+
+def test_upload_many_with_error(
+    caplog, fs_no_root, host, port, mocker, pycurl_mock, pycurl_instance
+):
+    multi_mock = mocker.patch("pyftpkit._pycurl.pycurl.CurlMulti")
+    multi_mock.return_value.perform.return_value = (0, 1)
+    multi_mock.return_value.info_read.return_value = (
+        0,
+        [],
+        [(pycurl_mock.return_value, pycurl.E_COULDNT_CONNECT, "error")],
+    )
+
+    src = pathlib.Path("test.txt")
+    src.write_text("")
+    dst = "/"
+
+    with caplog.at_level(logging.ERROR):
+        with pytest.raises(FTPError) as err:
+            pycurl_instance.upload_many([src], [dst])
+
+    url = f"ftp://{host!s}:{port!s}{dst!s}"
+
+    message = "File could not be uploaded to the FTP server."
+    assert message in caplog.text
+
+    message = f"Could not upload {str(src)!r} to {url!r} on FTP server."
+    assert message in str(err.value)
+
+
+def test_download_buffer_size(
+    fs_no_root, pycurl_mock, connection_parameters, pycurl_instance
+):
+    connection_parameters.buffer_size = 1_048_576
+
+    pycurl_instance.download("/text.txt", "text.txt")
+
+    pycurl_mock.return_value.setopt.assert_any_call(pycurl.BUFFERSIZE, 1_048_576)
+    pycurl_mock.return_value.setopt.assert_any_call(pycurl.WRITEFUNCTION, mock.ANY)
+
+
+def test_download_preallocate(tmp_path, pycurl_mock, pycurl_instance):
+    pycurl_mock.return_value.getinfo.return_value = 4096
+
+    dst = tmp_path / "text.txt"
+    with _FileSink(dst, pycurl_mock.return_value, preallocate=True) as sink:
+        assert sink.write(b"test") == 4
+        # The announced size is reserved upfront...
+        assert dst.stat().st_size in (4, 4096)
+
+    # ...and unused space is released once the transfer ends.
+    assert dst.read_bytes() == b"test"
+
+
+def test_download_with_write_error(
+    caplog, tmp_path, mocker, pycurl_mock, pycurl_instance
+):
+    mocker.patch("pyftpkit._pycurl.os.write", side_effect=OSError("error"))
+
+    def perform():
+        _, write = pycurl_mock.return_value.setopt.call_args_list[-1].args
+        assert write(b"test") == 0
+        raise pycurl.error(pycurl.E_WRITE_ERROR, "error")
+
+    pycurl_mock.return_value.perform.side_effect = perform
+
+    dst = tmp_path / "text.txt"
+    with caplog.at_level(logging.ERROR):
+        with pytest.raises(RuntimeError) as err:
+            pycurl_instance.download("/text.txt", dst)
+
+    message = "An error occurred while trying to write the buffer to disk."
+    assert message in caplog.text
+
+    message = f"Failed to write buffer data to: {dst!s}"
+    assert message in str(err.value)
+
+
+def test_download_segmented_small_file(mocker, pycurl_instance):
+    download_mock = mocker.patch.object(pycurl_instance, "download", return_value=1.0)
+
+    size_bytes = pycurl_instance.download_segmented(
+        "/text.txt", "text.txt", size=_MIN_SEGMENT_SIZE, segments=4
+    )
+    assert size_bytes == 1.0
+
+    download_mock.assert_called_once_with("/text.txt", "text.txt")
+
+
+def test_download_segmented_with_missing_data(
+    caplog, tmp_path, host, port, mocker, pycurl_mock, pycurl_instance
+):
+    multi_mock = mocker.patch("pyftpkit._pycurl.pycurl.CurlMulti")
+    multi_mock.return_value.perform.return_value = (0, 0)
+    multi_mock.return_value.info_read.return_value = (0, [], [])
+
+    src = "/file.bin"
+    dst = tmp_path / "file.bin"
+    size = 3 * _MIN_SEGMENT_SIZE
+
+    with caplog.at_level(logging.ERROR):
+        with pytest.raises(FTPError) as err:
+            pycurl_instance.download_segmented(src, dst, size=size, segments=4)
+
+    message = "Segmented download finished with missing data."
+    assert message in caplog.text
+
+    message = f"Incomplete data received from: ftp://{host!s}:{port!s}{src!s}"
+    assert message in str(err.value)
+
+    ranges = [
+        call.args[1]
+        for call in pycurl_mock.return_value.setopt.call_args_list
+        if call.args[0] == pycurl.RANGE
+    ]
+    step = _MIN_SEGMENT_SIZE
+    assert ranges == [
+        f"0-{step - 1}",
+        f"{step}-{2 * step - 1}",
+        f"{2 * step}-{3 * step - 1}",
+    ]
+    assert pycurl_mock.call_count == 3
+    assert multi_mock.return_value.remove_handle.call_count == 3
+
+    pycurl_instance.close()
+    multi_mock.return_value.close.assert_called_once()
+    assert pycurl_mock.return_value.close.call_count == 3